@@ -0,0 +1,105 @@
+#include "distributions/Dirichlet.h"
+#include "environments/MazeEnv.h"
+#include "math/Ops.h"
+#include "api/API.h"
+#include <torch/torch.h>
+#include <iostream>
+#include <chrono>
+
+using namespace hopi::environments;
+using namespace hopi::distributions;
+using namespace hopi::math;
+using namespace hopi::api;
+using namespace torch;
+using namespace torch::indexing;
+
+/**
+ * Compute the expected log of a Dirichlet element by element, i.e., the way it was computed before vectorisation.
+ * @param p the parameters of the Dirichlet
+ * @return the expected log
+ */
+Tensor loopExpectedLog(const Tensor &p) {
+    Tensor m = p.detach().clone();
+
+    Ops::unsqueeze(3 - m.dim(), {&m});
+    for (int i = 0; i < m.size(0); ++i) {
+        for (int j = 0; j < m.size(1); ++j) {
+            auto sum = m.index({i,j,Ellipsis}).sum().item<double>();
+            for (int k = 0; k < m.size(2); ++k) {
+                m[i][j][k] = Ops::digamma(m[i][j][k].item<double>()) - Ops::digamma(sum);
+            }
+        }
+    }
+    return torch::squeeze(m);
+}
+
+/**
+ * Compute the entropy of a Dirichlet slice by slice, i.e., the way it was computed before vectorisation.
+ * @param p the parameters of the Dirichlet
+ * @return the entropy
+ */
+double loopEntropy(const Tensor &p) {
+    Tensor m = p;
+    double e = 0;
+
+    Ops::unsqueeze(3 - m.dim(), {&m});
+    for (int i = 0; i < m.size(0); ++i) {
+        for (int j = 0; j < m.size(1); ++j) {
+            Tensor slice = m.index({i,j,Ellipsis});
+            double sum = slice.sum().item<double>();
+            double acc = 0;
+            for (int k = 0; k < slice.size(0); ++k) {
+                acc += (slice[k].item<double>() - 1) * Ops::digamma(slice[k].item<double>());
+            }
+            e += Dirichlet::logBeta(slice).item<double>() + (sum - (double) slice.size(0)) * Ops::digamma(sum) - acc;
+        }
+    }
+    return e;
+}
+
+/**
+ * Measure the average duration of a function.
+ * @param f the function to benchmark
+ * @param repeats the number of times the function is called
+ * @return the average duration in milliseconds
+ */
+template<class F>
+double benchmark(const F &f, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        f();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+int main() {
+    /**
+     ** Create a learned transition prior with the size of the largest maze.
+     **/
+    auto env = MazeEnv::create("../examples/mazes/7.maze");
+    Tensor theta_B = env->B() * 100 + torch::rand_like(env->B()) + 1;
+    Dirichlet B(theta_B);
+    int repeats = 10;
+
+    std::cout << "B's shape: " << theta_B.sizes() << std::endl;
+
+    /**
+     ** Compare the loop and vectorised implementations of the expected log.
+     **/
+    double loop_time = benchmark([&theta_B](){ loopExpectedLog(theta_B); }, repeats);
+    double fast_time = benchmark([&theta_B](){ Dirichlet::expectedLog(theta_B); }, repeats);
+    double error = (loopExpectedLog(theta_B) - Dirichlet::expectedLog(theta_B)).abs().max().item<double>();
+    std::cout << "Dirichlet::expectedLog: " << loop_time << " ms (loop) vs " << fast_time << " ms (vectorised), ";
+    std::cout << "speedup: " << loop_time / fast_time << "x, max error: " << error << std::endl;
+
+    /**
+     ** Compare the loop and vectorised implementations of the entropy.
+     **/
+    loop_time = benchmark([&theta_B](){ loopEntropy(theta_B); }, repeats);
+    fast_time = benchmark([&B](){ B.entropy(); }, repeats);
+    error = std::abs(loopEntropy(theta_B) - B.entropy());
+    std::cout << "Dirichlet::entropy: " << loop_time << " ms (loop) vs " << fast_time << " ms (vectorised), ";
+    std::cout << "speedup: " << loop_time / fast_time << "x, error: " << error << std::endl;
+    return 0;
+}
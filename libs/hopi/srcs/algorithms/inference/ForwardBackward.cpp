@@ -0,0 +1,140 @@
+#include "ForwardBackward.h"
+#include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Categorical.h"
+#include <torch/torch.h>
+
+using namespace hopi::graphs;
+using namespace hopi::nodes;
+using namespace hopi::distributions;
+using namespace torch;
+
+namespace hopi::algorithms::inference {
+
+    bool ForwardBackward::isChain(const std::shared_ptr<FactorGraph> &fg) {
+        std::vector<Slice> slices;
+        return extractChain(fg, slices);
+    }
+
+    bool ForwardBackward::extractChain(const std::shared_ptr<FactorGraph> &fg, std::vector<Slice> &slices) {
+        if (fg->batchSize() != 0) {
+            return false;
+        }
+
+        // Find the initial state, i.e., the only hidden variable that has a fixed prior and is not an action
+        VarNode *state = nullptr;
+        for (auto var : fg->getNodes()) {
+            if (var->parent() == nullptr)
+                return false;
+            if (var->type() != HIDDEN || var->parent()->type() != CATEGORICAL_NODE)
+                continue;
+            bool isAction = (var->nChildren() == 1 && (*var->firstChild())->type() == ACTIVE_TRANSITION_NODE
+                             && (*var->firstChild())->parent(1) == var);
+            if (isAction)
+                continue;
+            if (state != nullptr)
+                return false;
+            state = var;
+        }
+        if (state == nullptr || state->parent()->neighbours().size() != 1) {
+            return false;
+        }
+
+        // Follow the chain, and check that each hidden state has observed children and at most one next state
+        long visited = 0;
+        while (state != nullptr) {
+            Slice slice{state, nullptr, {}};
+            VarNode *next = nullptr;
+
+            for (auto it = state->firstChild(); it != state->lastChild(); ++it) {
+                FactorNode *factor = *it;
+                VarNode *child = factor->child();
+                if (factor->parent(0) != state) {
+                    return false;
+                } else if (factor->type() == TRANSITION_NODE && child->type() == OBSERVED && child->nChildren() == 0) {
+                    slice.observations.push_back(child);
+                } else if (next == nullptr && child->type() == HIDDEN && factor->type() == TRANSITION_NODE) {
+                    next = child;
+                } else if (next == nullptr && child->type() == HIDDEN && factor->type() == ACTIVE_TRANSITION_NODE) {
+                    VarNode *action = factor->parent(1);
+                    if (action->type() != HIDDEN || action->nChildren() != 1 ||
+                        action->parent()->type() != CATEGORICAL_NODE || action->parent()->neighbours().size() != 1)
+                        return false;
+                    slice.action = action;
+                    next = child;
+                } else {
+                    return false;
+                }
+                if (factor->neighbours().size() != ((factor->type() == TRANSITION_NODE) ? 2 : 3))
+                    return false;
+            }
+            visited += 1 + (long) slice.observations.size() + ((slice.action == nullptr) ? 0 : 1);
+            slices.push_back(slice);
+            state = next;
+        }
+
+        // Make sure that the chain covers the entire graph
+        return visited == fg->nodes();
+    }
+
+    bool ForwardBackward::inference(const std::shared_ptr<FactorGraph> &fg) {
+        std::vector<Slice> slices;
+        if (!extractChain(fg, slices)) {
+            return false;
+        }
+        auto T = slices.size();
+
+        // Compute the likelihood of the observations of each slice
+        std::vector<Tensor> likelihoods(T);
+        for (int t = 0; t < T; ++t) {
+            likelihoods[t] = torch::ones_like(slices[t].state->posterior()->paramsView());
+            for (auto o : slices[t].observations) {
+                Tensor A = o->prior()->paramsView();
+                likelihoods[t] = likelihoods[t] * matmul(A.permute({1,0}), o->posterior()->paramsView());
+            }
+        }
+
+        // Compute the transition matrix between each pair of consecutive slices, i.e., marginalise the actions
+        std::vector<Tensor> transitions(T - 1);
+        for (int t = 0; t + 1 < T; ++t) {
+            Tensor B = slices[t + 1].state->prior()->paramsView();
+            transitions[t] = (slices[t].action == nullptr) ? B : matmul(B, slices[t].action->prior()->paramsView());
+        }
+
+        // Forward pass
+        std::vector<Tensor> alpha(T);
+        alpha[0] = slices[0].state->prior()->paramsView() * likelihoods[0];
+        alpha[0] = alpha[0] / alpha[0].sum();
+        for (int t = 1; t < T; ++t) {
+            alpha[t] = matmul(transitions[t - 1], alpha[t - 1]) * likelihoods[t];
+            alpha[t] = alpha[t] / alpha[t].sum();
+        }
+
+        // Backward pass
+        std::vector<Tensor> beta(T);
+        beta[T - 1] = torch::ones_like(alpha[T - 1]);
+        for (int t = (int) T - 2; t >= 0; --t) {
+            beta[t] = matmul(transitions[t].permute({1,0}), likelihoods[t + 1] * beta[t + 1]);
+            beta[t] = beta[t] / beta[t].sum();
+        }
+
+        // Compute the posteriors of the states and actions
+        for (int t = 0; t < T; ++t) {
+            Tensor gamma = alpha[t] * beta[t];
+            slices[t].state->setPosterior(Categorical::create(gamma / gamma.sum()));
+
+            if (slices[t].action == nullptr)
+                continue;
+            Tensor B = slices[t + 1].state->prior()->paramsView();
+            Tensor w = likelihoods[t + 1] * beta[t + 1];
+            auto sizes = B.sizes();
+            Tensor M = matmul(w, B.reshape({sizes[0], sizes[1] * sizes[2]})).reshape({sizes[1], sizes[2]});
+            Tensor q = slices[t].action->prior()->paramsView() * matmul(alpha[t], M);
+            slices[t].action->setPosterior(Categorical::create(q / q.sum()));
+        }
+        fg->clearDirty();
+        return true;
+    }
+
+}
@@ -0,0 +1,62 @@
+#ifndef HOMING_PIGEON_FORWARD_BACKWARD_H
+#define HOMING_PIGEON_FORWARD_BACKWARD_H
+
+#include <memory>
+#include <vector>
+
+namespace hopi::nodes {
+    class VarNode;
+}
+namespace hopi::graphs {
+    class FactorGraph;
+}
+
+namespace hopi::algorithms::inference {
+
+    /**
+     * This class implements exact inference for chain-shaped graphs, i.e., graphs built by FactorGraph::integrate
+     * (without planning branches) in which s0 -> o0 and s_t -(a_t)-> s_{t+1} -> o_{t+1}. The actions are
+     * marginalised using their prior, and a single forward-backward pass computes the exact posteriors.
+     */
+    class ForwardBackward {
+    public:
+        /**
+         * Check whether the graph has the shape of a chain supported by the forward-backward algorithm, i.e., all
+         * the parameters are fixed, and each hidden state has observed children and at most one next state.
+         * @param fg the factor graph
+         * @return true if the graph is a chain, false otherwise
+         */
+        static bool isChain(const std::shared_ptr<graphs::FactorGraph> &fg);
+
+        /**
+         * Compute the exact posteriors of the hidden states and actions of a chain, and clear the graph's dirty
+         * nodes since all posteriors are up to date. The graph is left untouched if it is not a chain, in which case
+         * the caller is expected to fall back on another inference algorithm (e.g., VMP).
+         * @param fg the factor graph
+         * @return true if the graph is a chain and the posteriors were computed, false otherwise
+         */
+        static bool inference(const std::shared_ptr<graphs::FactorGraph> &fg);
+
+    private:
+        /**
+         * A slice of the chain, i.e., a hidden state, its observations, and the action leading to the next state
+         * (nullptr if the transition does not depend on any action or if the state is the last of the chain).
+         */
+        struct Slice {
+            nodes::VarNode *state;
+            nodes::VarNode *action;
+            std::vector<nodes::VarNode*> observations;
+        };
+
+        /**
+         * Extract the slices of a chain.
+         * @param fg the factor graph
+         * @param slices the output slices
+         * @return true if the graph is a chain, false otherwise
+         */
+        static bool extractChain(const std::shared_ptr<graphs::FactorGraph> &fg, std::vector<Slice> &slices);
+    };
+
+}
+
+#endif //HOMING_PIGEON_FORWARD_BACKWARD_H
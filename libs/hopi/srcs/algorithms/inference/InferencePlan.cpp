@@ -0,0 +1,203 @@
+#include "InferencePlan.h"
+#include "graphs/FactorGraph.h"
+#include "graphs/FlatGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Distribution.h"
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+using namespace hopi::graphs;
+using namespace hopi::nodes;
+using namespace torch;
+
+namespace hopi::algorithms::inference {
+
+    std::unique_ptr<InferencePlan> InferencePlan::create(const std::shared_ptr<FactorGraph> &fg) {
+        return std::make_unique<InferencePlan>(fg);
+    }
+
+    InferencePlan::InferencePlan(const std::shared_ptr<FactorGraph> &fg) {
+        _fg = fg;
+        _structure_version = -1;
+        compile();
+    }
+
+    InferencePlan::~InferencePlan() = default;
+
+    void InferencePlan::compile() {
+        if (_fg->batchSize() != 0) {
+            throw std::runtime_error("In InferencePlan::compile, unsupported batched graph.");
+        }
+        _views.clear();
+        _hidden.clear();
+        _operations.clear();
+        _params.clear();
+        _params_version.clear();
+        _log_params.clear();
+        _contributions.clear();
+        _updates.clear();
+
+        // The variables are stored in the belief buffer of a flat graph, and are identified by their handles
+        _flat = FlatGraph::create(_fg);
+        for (int i = 0; i < _flat->nVars(); ++i) {
+            _views.push_back(_flat->belief(i));
+            _hidden.push_back(_flat->varType(i) == HIDDEN);
+        }
+
+        // Create one operation for each factor, and keep track of the messages received by each hidden variable
+        std::vector<std::vector<Contribution>> contributions(_flat->nVars());
+        for (int i = 0; i < _flat->nFactors(); ++i) {
+            Operation op{_flat->factorType(i), (int) _params.size(), {-1, -1, -1}};
+            int n_slots = (int) (_flat->lastParent(i) - _flat->firstParent(i)) + 1;
+
+            if (op.type != CATEGORICAL_NODE && op.type != TRANSITION_NODE && op.type != ACTIVE_TRANSITION_NODE) {
+                throw std::runtime_error("In InferencePlan::compile, unsupported factor type.");
+            }
+            if (n_slots != ((op.type == CATEGORICAL_NODE) ? 1 : (op.type == TRANSITION_NODE) ? 2 : 3)) {
+                throw std::runtime_error("In InferencePlan::compile, unsupported learnable parameters.");
+            }
+            std::copy(_flat->firstParent(i), _flat->lastParent(i), op.slots);
+            op.slots[n_slots - 1] = _flat->child(i);
+            if (std::find(op.slots, op.slots + n_slots, -1) != op.slots + n_slots) {
+                throw std::runtime_error("In InferencePlan::compile, factor connected to a variable outside the graph.");
+            }
+            for (int role = 0; role < n_slots; ++role) {
+                if (_hidden[op.slots[role]]) {
+                    contributions[op.slots[role]].push_back({(int) _operations.size(), role});
+                }
+            }
+            _params.push_back(_flat->node(_flat->child(i)));
+            _params_version.push_back(-1);
+            _log_params.emplace_back();
+            _operations.push_back(op);
+        }
+
+        // Flatten the contributions of the hidden variables
+        for (int slot = 0; slot < _flat->nVars(); ++slot) {
+            if (!_hidden[slot])
+                continue;
+            Update update{slot, (int) _contributions.size(), 0};
+            _contributions.insert(_contributions.end(), contributions[slot].begin(), contributions[slot].end());
+            update.end = (int) _contributions.size();
+            _updates.push_back(update);
+        }
+
+        // The version is only recorded once the compilation succeeded, so that a failed compilation is retried
+        _structure_version = _fg->structureVersion();
+    }
+
+    bool InferencePlan::outdated() const {
+        return _structure_version != _fg->structureVersion();
+    }
+
+    void InferencePlan::run(double epsilon, int max_iter) {
+        if (outdated()) {
+            compile();
+        }
+        _flat->load();
+        loadParams();
+
+        double VFE = std::numeric_limits<double>::max();
+        int iter = 0;
+
+        while (true) {
+            // Perform inference
+            for (const Update &update : _updates) {
+                if (update.begin == update.end)
+                    continue;
+                Tensor post_param = message(_contributions[update.begin]);
+                for (int i = update.begin + 1; i < update.end; ++i) {
+                    post_param = post_param + message(_contributions[i]);
+                }
+                _views[update.slot].copy_(softmax(post_param, 0));
+            }
+
+            // Check if the variational free energy have converged
+            double new_VFE = vfe();
+
+            if (VFE - new_VFE < epsilon) {
+                break;
+            }
+            VFE = new_VFE;
+
+            // Check if the maximum number of iterations have been reached
+            if (iter >= max_iter) {
+                break;
+            }
+            ++iter;
+        }
+        _flat->store();
+    }
+
+    Tensor InferencePlan::message(const Contribution &contribution) {
+        const Operation &op = _operations[contribution.operation];
+        const Tensor &log_param = _log_params[op.param];
+
+        switch (op.type) {
+            case CATEGORICAL_NODE:
+                return log_param;
+            case TRANSITION_NODE:
+                if (contribution.role == 1) {
+                    return matmul(log_param, _views[op.slots[0]]);
+                }
+                return matmul(log_param.permute({1,0}), _views[op.slots[1]]);
+            default: {
+                // Active transition, i.e., log_param is indexed by (to, from, action)
+                auto sizes = log_param.sizes();
+                if (contribution.role == 1) {
+                    Tensor weights = outer(_views[op.slots[2]], _views[op.slots[0]]).reshape({-1});
+                    return matmul(log_param.reshape({sizes[0] * sizes[1], sizes[2]}).permute({1,0}), weights);
+                }
+                Tensor B_bar = matmul(log_param, _views[op.slots[1]]);
+                if (contribution.role == 2) {
+                    return matmul(B_bar, _views[op.slots[0]]);
+                }
+                return matmul(B_bar.permute({1,0}), _views[op.slots[2]]);
+            }
+        }
+    }
+
+    double InferencePlan::vfe() {
+        double VFE = 0;
+
+        for (const Operation &op : _operations) {
+            const Tensor &log_param = _log_params[op.param];
+            int child;
+            Tensor lp;
+
+            switch (op.type) {
+                case CATEGORICAL_NODE:
+                    child = op.slots[0];
+                    lp = log_param;
+                    break;
+                case TRANSITION_NODE:
+                    child = op.slots[1];
+                    lp = matmul(log_param, _views[op.slots[0]]);
+                    break;
+                default:
+                    child = op.slots[2];
+                    lp = matmul(matmul(log_param, _views[op.slots[1]]), _views[op.slots[0]]);
+                    break;
+            }
+            const Tensor &p = _views[child];
+            if (_hidden[child]) {
+                VFE += (p * p.log()).index({p != 0}).sum().item<double>();
+            }
+            VFE -= dot(lp, p).item<double>();
+        }
+        return VFE;
+    }
+
+    void InferencePlan::loadParams() {
+        for (int i = 0; i < _params.size(); ++i) {
+            auto prior = _params[i]->prior();
+            if (_params_version[i] != prior->version()) {
+                _log_params[i] = prior->logParams();
+                _params_version[i] = prior->version();
+            }
+        }
+    }
+
+}
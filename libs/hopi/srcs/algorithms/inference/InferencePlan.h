@@ -0,0 +1,131 @@
+#ifndef HOMING_PIGEON_INFERENCE_PLAN_H
+#define HOMING_PIGEON_INFERENCE_PLAN_H
+
+#include <memory>
+#include <vector>
+#include <torch/torch.h>
+#include "nodes/FactorNodeType.h"
+
+namespace hopi::nodes {
+    class VarNode;
+}
+namespace hopi::graphs {
+    class FactorGraph;
+    class FlatGraph;
+}
+
+namespace hopi::algorithms::inference {
+
+    /**
+     * This class compiles the structure of a factor graph into a flat list of operations over a contiguous buffer
+     * of beliefs. Running the plan performs the same updates as VMP::inference, but without virtual dispatch or
+     * iterators. The plan only supports (unbatched) graphs whose parameters are fixed, i.e., without Dirichlet
+     * priors, and is compiled again by the next run when the structure of the graph changes.
+     */
+    class InferencePlan {
+    public:
+        /**
+         * Compile the inference plan of a factor graph.
+         * @param fg the factor graph
+         * @return the inference plan
+         */
+        static std::unique_ptr<InferencePlan> create(const std::shared_ptr<graphs::FactorGraph> &fg);
+
+        /**
+         * Constructor, i.e., compile the inference plan of a factor graph.
+         * @param fg the factor graph
+         */
+        explicit InferencePlan(const std::shared_ptr<graphs::FactorGraph> &fg);
+
+        /**
+         * Destructor.
+         */
+        ~InferencePlan();
+
+        /**
+         * Getter.
+         * @return true if the structure of the graph changed since the plan was compiled, false otherwise
+         */
+        [[nodiscard]] bool outdated() const;
+
+        /**
+         * Iterates the updates of the hidden variables, starting from their current posteriors, then write the new
+         * posteriors in the graph. The plan is compiled again first if the graph's structure changed since it was
+         * compiled. The iteration of the updates stops if:
+         *  - the maximum number of iteration is reached;
+         *  - or the Variational Free Energy has converged.
+         * @param epsilon the convergence threshold under which the VFE has converged
+         * @param max_iter the maximum number of iterations
+         */
+        void run(double epsilon = 0.01, int max_iter = 2147483647);
+
+        /**
+         * Compute the Variational Free Energy (VFE) of the graph from the beliefs stored in the plan.
+         * @return the VFE
+         */
+        double vfe();
+
+    private:
+        /**
+         * A factor of the graph, the slots are the handles of the factor's variables in the flat graph, i.e.,
+         * (child) for a categorical, (from, to) for a transition, and (from, action, to) for an active transition.
+         */
+        struct Operation {
+            nodes::FactorNodeType type;
+            int param;
+            int slots[3];
+        };
+
+        /**
+         * A message that contributes to the update of a variable, i.e., the operation sending the message and the
+         * index of the receiving slot in the operation.
+         */
+        struct Contribution {
+            int operation;
+            int role;
+        };
+
+        /**
+         * The update of a hidden variable, i.e., the variable's slot and the range of its contributions.
+         */
+        struct Update {
+            int slot;
+            int begin;
+            int end;
+        };
+
+    private:
+        /**
+         * Compile the structure of the graph into the list of operations, and record the structure's version.
+         */
+        void compile();
+
+        /**
+         * Compute a message.
+         * @param contribution the operation sending the message and the index of the receiving slot
+         * @return the message
+         */
+        torch::Tensor message(const Contribution &contribution);
+
+        /**
+         * Refresh the log parameters of the factors whose prior changed since the last run.
+         */
+        void loadParams();
+
+    private:
+        std::shared_ptr<graphs::FactorGraph> _fg;
+        long _structure_version;
+        std::unique_ptr<graphs::FlatGraph> _flat;
+        std::vector<torch::Tensor> _views;
+        std::vector<bool> _hidden;
+        std::vector<Operation> _operations;
+        std::vector<nodes::VarNode*> _params;
+        std::vector<long> _params_version;
+        std::vector<torch::Tensor> _log_params;
+        std::vector<Contribution> _contributions;
+        std::vector<Update> _updates;
+    };
+
+}
+
+#endif //HOMING_PIGEON_INFERENCE_PLAN_H
@@ -0,0 +1,14 @@
+#ifndef HOMING_PIGEON_SCHEDULE_TYPE_H
+#define HOMING_PIGEON_SCHEDULE_TYPE_H
+
+namespace hopi::algorithms::inference {
+
+    enum ScheduleType : int {
+        SWEEP = 0,    // Update all hidden variables in turn until the VFE has converged
+        RESIDUAL = 1, // Update first the hidden variable whose neighbours changed the most
+        PARALLEL = 2  // Update concurrently the hidden variables that do not share any factor
+    };
+
+}
+
+#endif //HOMING_PIGEON_SCHEDULE_TYPE_H
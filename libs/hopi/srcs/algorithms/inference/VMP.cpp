@@ -6,28 +6,297 @@
 #include <distributions/Categorical.h>
 #include "nodes/FactorNode.h"
 #include "nodes/VarNode.h"
+#include "graphs/FactorGraph.h"
+#include "graphs/FlatGraph.h"
+#include "concurrency/ThreadPool.h"
+#include "VMPConfig.h"
+#include "VMPStats.h"
 #include "iterators/HiddenVarIter.h"
 #include "iterators/AdjacentFactorsIter.h"
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <mutex>
 
 using namespace hopi::graphs;
 using namespace hopi::iterators;
 using namespace hopi::distributions;
 using namespace hopi::nodes;
+using namespace hopi::concurrency;
 using namespace torch;
 
 namespace hopi::algorithms::inference {
 
+    static std::shared_ptr<ThreadPool> pool = nullptr;
+    static std::mutex poolMutex;
+
+    /**
+     * Getter.
+     * @return the thread pool used by the PARALLEL schedule, which is created on first use. The caller shares the
+     * ownership of the pool, which therefore stays alive until the caller is done with it, even if the pool is
+     * replaced by VMP::setNumberOfThreads in the meantime
+     */
+    static std::shared_ptr<ThreadPool> threadPool() {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        if (pool == nullptr) {
+            pool = ThreadPool::create((int) std::max(1u, std::thread::hardware_concurrency()));
+        }
+        return pool;
+    }
+
+    void VMP::setNumberOfThreads(int n) {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        pool = ThreadPool::create(n);
+    }
+
+    /**
+     * Getter.
+     * @param flat the flat graph
+     * @return the handles of the hidden variables of the flat graph
+     */
+    static std::vector<int> hiddenVars(const FlatGraph &flat) {
+        std::vector<int> hidden;
+        for (int i = 0; i < flat.nVars(); ++i) {
+            if (flat.varType(i) == HIDDEN) {
+                hidden.push_back(i);
+            }
+        }
+        return hidden;
+    }
+
+    /**
+     * Call a function on the handles of the factors adjacent to a variable, i.e., its children and then its parent.
+     * @param flat the flat graph
+     * @param var the variable's handle
+     * @param f the function
+     */
+    template<class F>
+    static void forEachFactor(const FlatGraph &flat, int var, F f) {
+        for (auto it = flat.firstChild(var); it != flat.lastChild(var); ++it) {
+            f(*it);
+        }
+        if (flat.parent(var) != -1) {
+            f(flat.parent(var));
+        }
+    }
+
+    /**
+     * Call a function on the handles of the variables connected to a factor, except the variables that do not
+     * belong to the flat graph.
+     * @param flat the flat graph
+     * @param factor the factor's handle
+     * @param f the function
+     */
+    template<class F>
+    static void forEachNeighbour(const FlatGraph &flat, int factor, F f) {
+        for (auto it = flat.firstParent(factor); it != flat.lastParent(factor); ++it) {
+            if (*it != -1) {
+                f(*it);
+            }
+        }
+        if (flat.child(factor) != -1) {
+            f(flat.child(factor));
+        }
+    }
+
+    /**
+     * Compute the natural parameters of a variable's posterior, i.e., the sum of the messages that its adjacent
+     * factors send to it.
+     * @param flat the flat graph
+     * @param var the variable's handle
+     * @return the natural parameters
+     */
+    static Tensor naturalParams(const FlatGraph &flat, int var) {
+        VarNode *node = flat.node(var);
+        Tensor post_param;
+        forEachFactor(flat, var, [&flat, node, &post_param](int factor) {
+            Tensor msg = flat.factor(factor)->message(node);
+            post_param = (post_param.numel() == 0) ? msg : post_param + msg;
+        });
+        return post_param;
+    }
+
+    /**
+     * Compute the variational free energy of the variables of a flat graph.
+     * @param flat the flat graph
+     * @return the variational free energy
+     */
+    static double flatVfe(const FlatGraph &flat) {
+        double VFE = 0;
+
+        for (int i = 0; i < flat.nVars(); ++i) {
+            if (flat.parent(i) != -1) {
+                VFE += flat.factor(flat.parent(i))->vfe();
+            }
+        }
+        return VFE;
+    }
+
     void VMP::inference(const std::vector<VarNode*>& vars, double epsilon, int max_iter) {
         double VFE = std::numeric_limits<double>::max();
         int iter = 0;
 
+        // The sweeps traverse the edges of a flat graph instead of chasing the pointers of the nodes
+        auto flat = FlatGraph::create(vars);
+        auto hidden = hiddenVars(*flat);
+
         while (true) {
             // Perform inference
-            HiddenVarIter hiddenIt(vars);
+            for (int var : hidden) {
+                flat->node(var)->posterior()->updateParams(naturalParams(*flat, var));
+            }
 
-            while (*hiddenIt != nullptr) {
-                inference(*hiddenIt);
-                ++hiddenIt;
+            // Check if the variational free energy have converged
+            double new_VFE = flatVfe(*flat);
+
+            if (VFE - new_VFE < epsilon) {
+                break;
+            }
+            VFE = new_VFE;
+
+            // Check if the maximum number of iterations have been reached
+            if (iter >= max_iter) {
+                break;
+            }
+            ++iter;
+        }
+    }
+
+    void VMP::inference(const std::vector<VarNode*>& vars, const ScheduleType &type, double epsilon, int max_iter) {
+        switch (type) {
+            case SWEEP:
+                inference(vars, epsilon, max_iter);
+                break;
+            case RESIDUAL:
+                residualInference(vars, vars, epsilon, max_iter);
+                break;
+            case PARALLEL:
+                parallelInference(vars, epsilon, max_iter);
+                break;
+            default:
+                throw std::runtime_error("In VMP::inference, unsupported schedule type.");
+        }
+    }
+
+    void VMP::inference(
+            const std::vector<VarNode*>& vars,
+            const std::shared_ptr<VMPConfig> &config,
+            VMPStats *stats
+    ) {
+        double omega = config->relaxation();
+        double tolerance = config->nodeTolerance();
+        double VFE = std::numeric_limits<double>::max();
+        int iter = 0;
+
+        // The largest change of the neighbours of each variable since its last update, indexed by handle
+        auto flat = FlatGraph::create(vars);
+        auto hidden = hiddenVars(*flat);
+        std::vector<double> changes(flat->nVars(), std::numeric_limits<double>::infinity());
+
+        while (true) {
+            int updates = 0;
+            int skipped = 0;
+
+            // Perform inference
+            for (int i : hidden) {
+                if (tolerance > 0 && changes[i] < tolerance) {
+                    ++skipped;
+                    continue;
+                }
+                VarNode *var = flat->node(i);
+                Tensor old_param = var->posterior()->paramsView();
+                Tensor post_param = naturalParams(*flat, i);
+                if (omega == 1 || var->posterior()->type() != DistributionType::CATEGORICAL) {
+                    // Only the natural parameters of the categorical distributions are relaxed, the posteriors of
+                    // the Dirichlet distributions are updated with counts
+                    var->posterior()->updateParams(post_param);
+                } else {
+                    Tensor old_natural = old_param.clamp_min(std::numeric_limits<float>::min()).log();
+                    var->posterior()->updateParams(omega * post_param + (1 - omega) * old_natural);
+                }
+                ++updates;
+
+                // Keep track of the largest change of the neighbours of each variable
+                if (tolerance > 0) {
+                    double change = (var->posterior()->paramsView() - old_param).abs().max().item<double>();
+                    changes[i] = 0;
+                    forEachFactor(*flat, i, [&flat, &changes, i, change](int factor) {
+                        forEachNeighbour(*flat, factor, [&changes, i, change](int neighbour) {
+                            if (neighbour != i) {
+                                changes[neighbour] = std::max(changes[neighbour], change);
+                            }
+                        });
+                    });
+                }
+            }
+
+            // Check if the variational free energy have converged
+            double new_VFE = flatVfe(*flat);
+            if (stats != nullptr) {
+                stats->addSweep(new_VFE, updates, skipped);
+            }
+
+            if (new_VFE > VFE && omega != 1) {
+                // The over-relaxed updates increased the VFE, the next sweeps use the standard updates that never do
+                omega = 1;
+            } else if (VFE - new_VFE < config->epsilon() || updates == 0) {
+                break;
+            }
+            VFE = new_VFE;
+
+            // Check if the maximum number of iterations have been reached
+            if (iter >= config->maxIter()) {
+                break;
+            }
+            ++iter;
+        }
+    }
+
+    std::vector<std::vector<VarNode*>> VMP::colour(const std::vector<VarNode*>& vars) {
+        std::vector<std::vector<VarNode*>> classes;
+        auto flat = FlatGraph::create(vars);
+        std::vector<int> colours(flat->nVars(), -1);
+
+        for (int var : hiddenVars(*flat)) {
+            // Collect the colours already used by the neighbours of the current variable
+            std::vector<bool> used(classes.size(), false);
+            forEachFactor(*flat, var, [&flat, &colours, &used](int factor) {
+                forEachNeighbour(*flat, factor, [&colours, &used](int neighbour) {
+                    if (colours[neighbour] != -1) {
+                        used[colours[neighbour]] = true;
+                    }
+                });
+            });
+
+            // Assign the smallest colour that is not used by any neighbour
+            size_t c = std::find(used.begin(), used.end(), false) - used.begin();
+            if (c == classes.size()) {
+                classes.emplace_back();
+            }
+            classes[c].push_back(flat->node(var));
+            colours[var] = (int) c;
+        }
+        return classes;
+    }
+
+    void VMP::parallelInference(const std::vector<VarNode*>& vars, double epsilon, int max_iter) {
+        double VFE = std::numeric_limits<double>::max();
+        auto classes = colour(vars);
+        auto workers = threadPool();
+        int iter = 0;
+
+        while (true) {
+            // Perform inference, the variables of a colour class do not share any factor and can be updated
+            // concurrently
+            for (auto &colourClass : classes) {
+                std::vector<std::function<void()>> tasks;
+                for (auto var : colourClass) {
+                    tasks.emplace_back([var](){ inference(var); });
+                }
+                workers->run(tasks);
             }
 
             // Check if the variational free energy have converged
@@ -46,6 +315,81 @@ namespace hopi::algorithms::inference {
         }
     }
 
+    void VMP::incrementalInference(const std::shared_ptr<FactorGraph> &fg, double epsilon, int max_iter) {
+        // The dirty frontier contains the dirty nodes and their neighbours, observed dirty nodes (e.g., a new
+        // observation) are never updated but their neighbours must be
+        std::vector<VarNode*> seeds;
+        for (auto node : fg->dirtyNodes()) {
+            for (AdjacentFactorsIter factorIt(node); *factorIt != nullptr; ++factorIt) {
+                for (auto neighbour : (*factorIt)->neighbours()) {
+                    if (std::find(seeds.begin(), seeds.end(), neighbour) == seeds.end()) {
+                        seeds.push_back(neighbour);
+                    }
+                }
+            }
+        }
+        residualInference(fg->getNodes(), seeds, epsilon, max_iter);
+        fg->clearDirty();
+    }
+
+    void VMP::residualInference(
+            const std::vector<VarNode*>& vars,
+            const std::vector<VarNode*>& seeds,
+            double epsilon,
+            int max_iter
+    ) {
+        using Entry = std::tuple<double, long, VarNode*>;
+
+        // Initialise the residuals of the seeds to infinity, so that each of them is updated at least once
+        std::priority_queue<Entry> queue;
+        std::unordered_map<VarNode*, double> residuals;
+        long order = 0;
+        for (HiddenVarIter it(vars); *it != nullptr; ++it) {
+            residuals[*it] = 0;
+        }
+        for (HiddenVarIter it(seeds); *it != nullptr; ++it) {
+            auto r = residuals.find(*it);
+            if (r != residuals.end()) {
+                r->second = std::numeric_limits<double>::infinity();
+                queue.emplace(r->second, order--, *it);
+            }
+        }
+
+        // Update the variable with the largest residual until convergence
+        long maxUpdates = (long) max_iter * (long) residuals.size();
+        for (long n = 0; !queue.empty() && n < maxUpdates; ++n) {
+            auto [residual, index, var] = queue.top();
+            queue.pop();
+
+            // Skip outdated entries, i.e., entries whose residual has been updated since their insertion
+            if (residual != residuals[var]) {
+                --n;
+                continue;
+            }
+            if (residual < epsilon) {
+                break;
+            }
+
+            // Update the posterior and compute how much it changed
+            Tensor old_param = var->posterior()->paramsView();
+            inference(var);
+            residuals[var] = 0;
+            double change = (var->posterior()->paramsView() - old_param).abs().max().item<double>();
+
+            // Increase the residuals of the neighbouring variables
+            for (AdjacentFactorsIter factorIt(var); *factorIt != nullptr; ++factorIt) {
+                for (auto neighbour : (*factorIt)->neighbours()) {
+                    auto r = residuals.find(neighbour);
+                    if (neighbour == var || r == residuals.end() || r->second >= change) {
+                        continue;
+                    }
+                    r->second = change;
+                    queue.emplace(change, order--, neighbour);
+                }
+            }
+        }
+    }
+
     void VMP::inference(VarNode *var) {
         Tensor post_param;
         AdjacentFactorsIter factorIt(var);
@@ -54,7 +398,7 @@ namespace hopi::algorithms::inference {
             if (post_param.numel() == 0) {
                 post_param = (*factorIt)->message(var);
             } else {
-                post_param += (*factorIt)->message(var);
+                post_param = post_param + (*factorIt)->message(var);
             }
             ++factorIt;
         }
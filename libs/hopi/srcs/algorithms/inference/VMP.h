@@ -7,13 +7,20 @@
 
 #include <memory>
 #include <vector>
+#include "ScheduleType.h"
 
 namespace hopi::nodes {
     class VarNode;
 }
+namespace hopi::graphs {
+    class FactorGraph;
+}
 
 namespace hopi::algorithms::inference {
 
+    class VMPConfig;
+    class VMPStats;
+
     /**
      * This class implement the Variational Message Passing algorithm used to perform inference of the latent variables.
      */
@@ -23,12 +30,80 @@ namespace hopi::algorithms::inference {
          * Iterates the updates corresponding to the inputs variables. The iteration of the updates stops if:
          *  - the maximum number of iteration is reached;
          *  - or the Variational Free Energy has converged.
+         * The sweeps traverse a flat graph (see graphs::FlatGraph) built from the input variables.
          * @param vars the input variables
          * @param epsilon the convergence threshold under which the VFE has converged
          * @param max_iter the maximum number of iterations
          */
         static void inference(const std::vector<nodes::VarNode*>& vars, double epsilon = 0.01, int max_iter = 2147483647);
 
+        /**
+         * Iterates the updates corresponding to the inputs variables using the requested schedule. When the schedule
+         * is SWEEP, this function behaves as the function above. When the schedule is RESIDUAL, the variables are
+         * stored in a priority queue keyed on how much their neighbours changed since their last update, and the
+         * updates stop when no variable has a residual above epsilon. When the schedule is PARALLEL, the hidden
+         * variables are coloured such that no two variables sharing a factor have the same colour, and the variables
+         * of each colour class are updated concurrently.
+         * @param vars the input variables
+         * @param type the schedule to use
+         * @param epsilon the convergence threshold (on the VFE for SWEEP, and on the residuals for RESIDUAL)
+         * @param max_iter the maximum number of iterations, where an iteration corresponds to as many updates as
+         * there are hidden variables
+         */
+        static void inference(
+                const std::vector<nodes::VarNode*>& vars,
+                const ScheduleType &type,
+                double epsilon = 0.01,
+                int max_iter = 2147483647
+        );
+
+        /**
+         * Iterates the updates corresponding to the inputs variables using the input configuration, i.e., the
+         * natural parameters of the categorical posteriors are relaxed using the relaxation factor (the Dirichlet
+         * posteriors receive the standard updates), and a variable is skipped
+         * if none of its neighbours changed by more than the per-node tolerance since its last update. If a sweep of
+         * relaxed updates increases the VFE, the next sweeps fall back on the standard updates (i.e., a relaxation
+         * factor of one). The iteration of the updates stops if the maximum number of iteration is reached or the VFE
+         * has converged.
+         * @param vars the input variables
+         * @param config the configuration of the algorithm
+         * @param stats the telemetry of each sweep, if not nullptr
+         */
+        static void inference(
+                const std::vector<nodes::VarNode*>& vars,
+                const std::shared_ptr<VMPConfig> &config,
+                VMPStats *stats = nullptr
+        );
+
+        /**
+         * Re-infers only the part of the graph affected by the nodes marked as dirty since the last call to this
+         * function, e.g., the slice added by FactorGraph::integrate. The posteriors of the other nodes are used as
+         * a starting point, and are only updated if the residuals of their neighbours exceed epsilon. The dirty
+         * nodes are cleared at the end of the inference.
+         * @param fg the factor graph on which inference is performed
+         * @param epsilon the residual under which a variable is considered as converged
+         * @param max_iter the maximum number of iterations
+         */
+        static void incrementalInference(
+                const std::shared_ptr<graphs::FactorGraph> &fg,
+                double epsilon = 0.01,
+                int max_iter = 2147483647
+        );
+
+        /**
+         * Colour the hidden variables such that no two variables connected to the same factor have the same colour.
+         * @param vars the input variables
+         * @return the colour classes, i.e., the i-th element contains all the hidden variables of colour i
+         */
+        static std::vector<std::vector<nodes::VarNode*>> colour(const std::vector<nodes::VarNode*>& vars);
+
+        /**
+         * Setter.
+         * @param n the number of threads used by the PARALLEL schedule, the inferences that are already running keep
+         * using the previous threads until they return
+         */
+        static void setNumberOfThreads(int n);
+
         /**
          * Perform one iteration of the inference updates.
          * @param var the list of variables whose updates must be iterated
@@ -41,6 +116,34 @@ namespace hopi::algorithms::inference {
          * @return the VFE
          */
         static double vfe(const std::vector<nodes::VarNode*>& vars);
+
+    private:
+        /**
+         * Iterates the updates corresponding to the inputs variables, the variables of each colour class are updated
+         * concurrently. The iteration of the updates stops if:
+         *  - the maximum number of iteration is reached;
+         *  - or the Variational Free Energy has converged.
+         * @param vars the input variables
+         * @param epsilon the convergence threshold under which the VFE has converged
+         * @param max_iter the maximum number of iterations
+         */
+        static void parallelInference(const std::vector<nodes::VarNode*>& vars, double epsilon, int max_iter);
+
+        /**
+         * Iterates the updates corresponding to the inputs variables, the next variable to be updated is the one
+         * with the largest residual, i.e., the largest change of its neighbours' posterior since its last update.
+         * @param vars the input variables
+         * @param seeds the variables that must be updated at least once, the others are only updated if the
+         * posterior of one of their neighbours changes
+         * @param epsilon the residual under which a variable is considered as converged
+         * @param max_iter the maximum number of iterations
+         */
+        static void residualInference(
+                const std::vector<nodes::VarNode*>& vars,
+                const std::vector<nodes::VarNode*>& seeds,
+                double epsilon,
+                int max_iter
+        );
     };
 
 }
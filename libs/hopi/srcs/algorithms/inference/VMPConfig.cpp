@@ -0,0 +1,57 @@
+#include "VMPConfig.h"
+
+namespace hopi::algorithms::inference {
+
+    std::shared_ptr<VMPConfig> VMPConfig::create(double epsilon, int maxIter, double relaxation, double nodeTolerance) {
+        return std::make_shared<VMPConfig>(epsilon, maxIter, relaxation, nodeTolerance);
+    }
+
+    VMPConfig::VMPConfig(double epsilon, int maxIter, double relaxation, double nodeTolerance) {
+        _epsilon = epsilon;
+        _maxIter = maxIter;
+        _relaxation = relaxation;
+        _nodeTolerance = nodeTolerance;
+    }
+
+    double VMPConfig::epsilon() const {
+        return _epsilon;
+    }
+
+    int VMPConfig::maxIter() const {
+        return _maxIter;
+    }
+
+    double VMPConfig::relaxation() const {
+        return _relaxation;
+    }
+
+    double VMPConfig::nodeTolerance() const {
+        return _nodeTolerance;
+    }
+
+    void VMPConfig::setEpsilon(double value) {
+        _epsilon = value;
+    }
+
+    void VMPConfig::setMaxIter(int value) {
+        _maxIter = value;
+    }
+
+    void VMPConfig::setRelaxation(double value) {
+        _relaxation = value;
+    }
+
+    void VMPConfig::setNodeTolerance(double value) {
+        _nodeTolerance = value;
+    }
+
+    void VMPConfig::print(std::ostream &output) const {
+        output << "========== VMP CONFIGURATION ==========" << std::endl;
+        output << "Convergence threshold: " << _epsilon << std::endl;
+        output << "Maximum number of iterations: " << _maxIter << std::endl;
+        output << "Relaxation factor: " << _relaxation << std::endl;
+        output << "Per-node tolerance: " << _nodeTolerance << std::endl;
+        output << std::endl;
+    }
+
+}
@@ -0,0 +1,106 @@
+#ifndef HOMING_PIGEON_VMP_CONFIG_H
+#define HOMING_PIGEON_VMP_CONFIG_H
+
+#include <memory>
+#include <ostream>
+
+namespace hopi::algorithms::inference {
+
+    /**
+     * A class storing the configuration of the VMP algorithm.
+     */
+    class VMPConfig {
+    public:
+        /**
+         * Create a configuration for the VMP algorithm.
+         * @param epsilon the convergence threshold under which the VFE has converged.
+         * @param maxIter the maximum number of iterations.
+         * @param relaxation the relaxation factor applied to the natural parameters of the categorical posteriors,
+         * i.e., the new natural parameters are (1 - relaxation) * old + relaxation * new. A value of one corresponds
+         * to the standard VMP updates, and values above one to over-relaxed (i.e., accelerated) updates. The
+         * Dirichlet posteriors always receive the standard updates, and the categorical posteriors receive them too
+         * once a sweep of over-relaxed updates has increased the VFE.
+         * @param nodeTolerance the per-node convergence tolerance, i.e., a variable is not updated if none of its
+         * neighbours' posteriors changed by more than the tolerance since its last update.
+         * @return the configuration.
+         */
+        static std::shared_ptr<VMPConfig> create(
+                double epsilon = 0.01,
+                int maxIter = 2147483647,
+                double relaxation = 1.0,
+                double nodeTolerance = 0.0
+        );
+
+        /**
+         * Constructor.
+         * @param epsilon the convergence threshold under which the VFE has converged.
+         * @param maxIter the maximum number of iterations.
+         * @param relaxation the relaxation factor applied to the natural parameters of the posteriors.
+         * @param nodeTolerance the per-node convergence tolerance.
+         */
+        VMPConfig(double epsilon, int maxIter, double relaxation, double nodeTolerance);
+
+        /**
+         * Getter.
+         * @return the convergence threshold under which the VFE has converged.
+         */
+        [[nodiscard]] double epsilon() const;
+
+        /**
+         * Getter.
+         * @return the maximum number of iterations.
+         */
+        [[nodiscard]] int maxIter() const;
+
+        /**
+         * Getter.
+         * @return the relaxation factor applied to the natural parameters of the posteriors.
+         */
+        [[nodiscard]] double relaxation() const;
+
+        /**
+         * Getter.
+         * @return the per-node convergence tolerance.
+         */
+        [[nodiscard]] double nodeTolerance() const;
+
+        /**
+         * Setter.
+         * @param value new convergence threshold.
+         */
+        void setEpsilon(double value);
+
+        /**
+         * Setter.
+         * @param value new maximum number of iterations.
+         */
+        void setMaxIter(int value);
+
+        /**
+         * Setter.
+         * @param value new relaxation factor.
+         */
+        void setRelaxation(double value);
+
+        /**
+         * Setter.
+         * @param value new per-node convergence tolerance.
+         */
+        void setNodeTolerance(double value);
+
+        /**
+         * Print the configuration in the output stream.
+         * @param output the stream
+         */
+        void print(std::ostream &output) const;
+
+    private:
+        double _epsilon;
+        int _maxIter;
+        double _relaxation;
+        double _nodeTolerance;
+    };
+
+}
+
+#endif //HOMING_PIGEON_VMP_CONFIG_H
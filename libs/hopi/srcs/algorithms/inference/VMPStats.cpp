@@ -0,0 +1,53 @@
+#include <iostream>
+#include <numeric>
+#include "VMPStats.h"
+
+namespace hopi::algorithms::inference {
+
+    void VMPStats::addSweep(double vfe, int updates, int skipped) {
+        _vfe.push_back(vfe);
+        _updates.push_back(updates);
+        _skipped.push_back(skipped);
+    }
+
+    void VMPStats::clear() {
+        _vfe.clear();
+        _updates.clear();
+        _skipped.clear();
+    }
+
+    int VMPStats::nbSweeps() const {
+        return (int) _vfe.size();
+    }
+
+    double VMPStats::vfe(int i) const {
+        return _vfe[i];
+    }
+
+    int VMPStats::updates(int i) const {
+        return _updates[i];
+    }
+
+    int VMPStats::skipped(int i) const {
+        return _skipped[i];
+    }
+
+    int VMPStats::totalUpdates() const {
+        return std::accumulate(_updates.begin(), _updates.end(), 0);
+    }
+
+    int VMPStats::totalSkipped() const {
+        return std::accumulate(_skipped.begin(), _skipped.end(), 0);
+    }
+
+    void VMPStats::print(std::ostream &output) const {
+        output << "========== VMP STATISTICS ==========" << std::endl;
+        for (int i = 0; i < nbSweeps(); ++i) {
+            output << "Sweep " << i << ": VFE = " << _vfe[i] << ", updates = " << _updates[i];
+            output << ", skipped = " << _skipped[i] << std::endl;
+        }
+        output << "Total: updates = " << totalUpdates() << ", skipped = " << totalSkipped() << std::endl;
+        output << std::endl;
+    }
+
+}
@@ -0,0 +1,82 @@
+#ifndef HOMING_PIGEON_VMP_STATS_H
+#define HOMING_PIGEON_VMP_STATS_H
+
+#include <vector>
+#include <ostream>
+
+namespace hopi::algorithms::inference {
+
+    /**
+     * A class storing the telemetry of a run of the VMP algorithm, i.e., for each sweep over the hidden variables,
+     * the VFE at the end of the sweep, the number of variables updated, and the number of variables skipped because
+     * they had already converged.
+     */
+    class VMPStats {
+    public:
+        /**
+         * Record the telemetry of a sweep.
+         * @param vfe the VFE at the end of the sweep
+         * @param updates the number of variables updated
+         * @param skipped the number of variables skipped
+         */
+        void addSweep(double vfe, int updates, int skipped);
+
+        /**
+         * Remove the telemetry of all sweeps.
+         */
+        void clear();
+
+        /**
+         * Getter.
+         * @return the number of sweeps
+         */
+        [[nodiscard]] int nbSweeps() const;
+
+        /**
+         * Getter.
+         * @param i the index of the sweep
+         * @return the VFE at the end of the i-th sweep
+         */
+        [[nodiscard]] double vfe(int i) const;
+
+        /**
+         * Getter.
+         * @param i the index of the sweep
+         * @return the number of variables updated during the i-th sweep
+         */
+        [[nodiscard]] int updates(int i) const;
+
+        /**
+         * Getter.
+         * @param i the index of the sweep
+         * @return the number of variables skipped during the i-th sweep
+         */
+        [[nodiscard]] int skipped(int i) const;
+
+        /**
+         * Getter.
+         * @return the number of variables updated during all the sweeps
+         */
+        [[nodiscard]] int totalUpdates() const;
+
+        /**
+         * Getter.
+         * @return the number of variables skipped during all the sweeps
+         */
+        [[nodiscard]] int totalSkipped() const;
+
+        /**
+         * Print the telemetry in the output stream.
+         * @param output the stream
+         */
+        void print(std::ostream &output) const;
+
+    private:
+        std::vector<double> _vfe;
+        std::vector<int> _updates;
+        std::vector<int> _skipped;
+    };
+
+}
+
+#endif //HOMING_PIGEON_VMP_STATS_H
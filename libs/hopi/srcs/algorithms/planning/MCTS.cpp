@@ -7,6 +7,7 @@
 #include "nodes/VarNode.h"
 #include "nodes/FactorNode.h"
 #include "distributions/Distribution.h"
+#include "distributions/Categorical.h"
 #include "algorithms/planning/MCTSNodeData.h"
 #include "algorithms/inference/VMP.h"
 #include "api/API.h"
@@ -40,7 +41,7 @@ namespace hopi::algorithms::planning {
             std::vector<FactorNode*> copy;
             std::copy_if(
                     curr->firstChild(), curr->lastChild(), std::back_inserter(copy),
-                    [](FactorNode *n){return n->child()->data()->action != -1;}
+                    [](FactorNode *n){return n->child()->action() != -1;}
             );
             curr = (*std::max_element(copy.begin(), copy.end(), compUCT))->child();
         }
@@ -65,6 +66,17 @@ namespace hopi::algorithms::planning {
         return expandedNodes;
     }
 
+    void MCTS::prediction(const std::vector<VarNode*> &nodes) {
+        for (int i = 0; i < nodes.size(); i += 2) {
+            VarNode *s = nodes[i];
+            VarNode *o = nodes[i + 1];
+            Tensor sBeliefs = matmul(s->prior()->paramsView(), parent(s)->posterior()->paramsView());
+            Tensor oBeliefs = matmul(o->prior()->paramsView(), sBeliefs);
+            s->setPosterior(Categorical::create(sBeliefs));
+            o->setPosterior(Categorical::create(oBeliefs));
+        }
+    }
+
     void MCTS::evaluation(const std::vector<VarNode*> &nodes, const torch::Tensor &a, const EvaluationType &type) {
         static std::map<EvaluationType, EvaluationFunction> eFunctions = {
                 {EFE, &MCTS::efe},
@@ -74,8 +86,8 @@ namespace hopi::algorithms::planning {
         if (eFunctions.find(type) == eFunctions.end())
             throw std::runtime_error("In MCTS::evaluation, unsupported evaluation type.");
         for (int i = 0; i < nodes.size(); i += 2) {
-            auto sBeliefs = nodes[i]->posterior()->params();
-            auto oBeliefs = nodes[i + 1]->posterior()->params();
+            auto sBeliefs = nodes[i]->posterior()->paramsView();
+            auto oBeliefs = nodes[i + 1]->posterior()->paramsView();
             nodes[i]->data()->cost = eFunctions[type](sBeliefs, oBeliefs, a, _config);
         }
     }
@@ -84,7 +96,7 @@ namespace hopi::algorithms::planning {
         std::vector<VarNode*> copy;
         std::copy_if (
                 nodes.begin(), nodes.end(), std::back_inserter(copy),
-                [](VarNode *n){return n->data()->action != -1;}
+                [](VarNode *n){return n->action() != -1;}
         );
         auto bestChild = *std::min_element(copy.begin(), copy.end(), &MCTS::compareCost);
         double cost = bestChild->data()->cost;
@@ -144,7 +156,7 @@ namespace hopi::algorithms::planning {
 
         for (int i = 0; i < root->nChildren(); ++i) {
             auto child = root->child(i);
-            int action = child->data()->action;
+            int action = child->action();
             if (action == -1)
                 continue;
             w[action] = - _config->actionPrecision() * child->data()->cost / child->data()->visits;
@@ -59,6 +59,14 @@ namespace hopi::algorithms::planning {
          */
         static std::vector<hopi::nodes::VarNode*> expansion(hopi::nodes::VarNode *node, const torch::Tensor &a, const torch::Tensor &b);
 
+        /**
+         * Compute the posterior beliefs of the newly expanded nodes in one forward pass, i.e., the beliefs over
+         * the future states are B[:,:,action] @ parent's beliefs and the beliefs over the future observations are
+         * A @ states' beliefs. This is cheaper than an iterative inference since the expanded nodes are unobserved.
+         * @param nodes the newly expanded nodes, as returned by MCTS::expansion.
+         */
+        static void prediction(const std::vector<hopi::nodes::VarNode*> &nodes);
+
         /**
          * Evaluate the cost of all expanded nodes.
          * @param nodes the newly expanded nodes.
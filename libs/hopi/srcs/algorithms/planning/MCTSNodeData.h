@@ -6,13 +6,14 @@
 #define EXPERIMENTS_AI_TS_MCTS_NODE_DATA_H
 
 #include <memory>
+#include "memory/PoolAllocator.h"
 
 namespace hopi::algorithms::planning {
 
     /**
      * A class storing the data of a node used by the MCTS algorithm.
      */
-    class MCTSNodeData {
+    class MCTSNodeData : public memory::PoolAllocated {
     public:
         /**
          * Create default node's data for MCTS planning algorithm;
@@ -23,6 +23,18 @@ using namespace torch;
 
 namespace hopi::api {
 
+    /**
+     * Create the uniform posterior of a new variable, the posterior is a [batch size, dim] tensor if the current
+     * factor graph is batched.
+     * @param dim the number of values that the variable can take
+     * @return the posterior parameters
+     */
+    static Tensor uniformPosterior(long dim) {
+        long batch_size = FactorGraph::current()->batchSize();
+
+        return (batch_size == 0) ? Ops::uniform({dim}) : Ops::uniform({batch_size, dim}, 1);
+    }
+
     RV *API::Categorical(const std::shared_ptr<Tensor> &param) {
         return API::Categorical(Categorical::create(param));
     }
@@ -37,8 +49,8 @@ namespace hopi::api {
         FactorNode *factor = fg->addFactor(CategoricalNode::create(var, param));
 
         var->setParent(factor);
-        auto dim = param->prior()->params().size(0);
-        var->setPosterior(Categorical::create(Ops::uniform({dim})));
+        auto dim = param->prior()->paramsView().size(0);
+        var->setPosterior(Categorical::create(uniformPosterior(dim)));
 
         param->addChild(factor);
         return var;
@@ -58,8 +70,8 @@ namespace hopi::api {
         FactorNode *factor = fg->addFactor(TransitionNode::create(s, var, param));
 
         var->setParent(factor);
-        auto dim = param->prior()->params().size(0);
-        var->setPosterior(Categorical::create(Ops::uniform({dim})));
+        auto dim = param->prior()->paramsView().size(0);
+        var->setPosterior(Categorical::create(uniformPosterior(dim)));
 
         s->addChild(factor);
         param->addChild(factor);
@@ -80,8 +92,8 @@ namespace hopi::api {
         FactorNode *factor = fg->addFactor(ActiveTransitionNode::create(s, a, var, param));
 
         var->setParent(factor);
-        auto dim = param->prior()->params().size(0);
-        var->setPosterior(Categorical::create(Ops::uniform({dim})));
+        auto dim = param->prior()->paramsView().size(0);
+        var->setPosterior(Categorical::create(uniformPosterior(dim)));
 
         s->addChild(factor);
         a->addChild(factor);
@@ -97,7 +109,7 @@ namespace hopi::api {
         return API::Dirichlet(Dirichlet::create(param), Dirichlet::create(*param));
     }
 
-    static ScalarType dType = kDouble;
+    static thread_local ScalarType dType = kDouble;
 
     void API::setDataType(const ScalarType &type) {
         dType = type;
@@ -143,11 +155,11 @@ namespace hopi::api {
         auto fg = FactorGraph::current();
         VarNode *var = fg->addNode(VarNode::create(VarNodeType::HIDDEN));
         FactorNode *factor = fg->addFactor(CategoricalNode::create(var));
-        long nb_params = prior->params().size(0);
+        long nb_params = prior->paramsView().size(prior->paramsView().dim() - 1);
 
         var->setParent(factor);
         var->setPrior(std::move(prior));
-        var->setPosterior(Categorical::create(Ops::uniform({nb_params})));
+        var->setPosterior(Categorical::create(uniformPosterior(nb_params)));
         return var;
     }
 
@@ -155,11 +167,11 @@ namespace hopi::api {
         auto fg = FactorGraph::current();
         VarNode *var = fg->addNode(VarNode::create(VarNodeType::HIDDEN));
         FactorNode *factor = fg->addFactor(TransitionNode::create(s, var));
-        long nb_params = prior->params().size(0);
+        long nb_params = prior->paramsView().size(0);
 
         var->setParent(factor);
         var->setPrior(std::move(prior));
-        var->setPosterior(Categorical::create(Ops::uniform({nb_params})));
+        var->setPosterior(Categorical::create(uniformPosterior(nb_params)));
 
         s->addChild(factor);
         return var;
@@ -169,11 +181,11 @@ namespace hopi::api {
         auto fg = FactorGraph::current();
         VarNode *var = fg->addNode(VarNode::create(VarNodeType::HIDDEN));
         FactorNode *factor = fg->addFactor(ActiveTransitionNode::create(s, a, var));
-        long nb_params = prior->params().size(0);
+        long nb_params = prior->paramsView().size(0);
 
         var->setParent(factor);
         var->setPrior(std::move(prior));
-        var->setPosterior(Categorical::create(Ops::uniform({nb_params})));
+        var->setPosterior(Categorical::create(uniformPosterior(nb_params)));
 
         s->addChild(factor);
         a->addChild(factor);
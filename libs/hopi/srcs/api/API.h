@@ -146,7 +146,7 @@ namespace hopi::api {
         //
 
         /**
-         * Setter.
+         * Setter, the type of data is specific to the calling thread.
          * @param type the type of data that must be used when creating a tensor
          */
         static void setDataType(const at::ScalarType& type);
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+#include <exception>
+
+namespace hopi::concurrency {
+
+    std::unique_ptr<ThreadPool> ThreadPool::create(int nThreads) {
+        return std::make_unique<ThreadPool>(nThreads);
+    }
+
+    ThreadPool::ThreadPool(int nThreads) : _stop(false) {
+        for (int i = 0; i < nThreads; ++i) {
+            _workers.emplace_back([this](){ work(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this](){ return _stop || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop();
+            }
+            task();
+        }
+    }
+
+    void ThreadPool::run(const std::vector<std::function<void()>> &tasks) {
+        // Without worker threads, the tasks are executed by the calling thread
+        if (_workers.empty()) {
+            for (auto &task : tasks) {
+                task();
+            }
+            return;
+        }
+
+        // Each call keeps track of its own tasks, so that concurrent callers only wait for their own tasks
+        struct Batch {
+            std::mutex mutex;
+            std::condition_variable done;
+            size_t remaining;
+            std::exception_ptr error;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->remaining = tasks.size();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (auto &task : tasks) {
+                _tasks.emplace([batch, task](){
+                    std::exception_ptr error;
+                    try {
+                        task();
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    std::unique_lock<std::mutex> lock(batch->mutex);
+                    if (error && !batch->error) {
+                        batch->error = error;
+                    }
+                    if (--batch->remaining == 0) {
+                        batch->done.notify_all();
+                    }
+                });
+            }
+        }
+        _condition.notify_all();
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->done.wait(lock, [&batch](){ return batch->remaining == 0; });
+        if (batch->error) {
+            std::rethrow_exception(batch->error);
+        }
+    }
+
+    int ThreadPool::size() const {
+        return (int) _workers.size();
+    }
+
+}
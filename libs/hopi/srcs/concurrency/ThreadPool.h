@@ -0,0 +1,67 @@
+#ifndef HOMING_PIGEON_THREAD_POOL_H
+#define HOMING_PIGEON_THREAD_POOL_H
+
+#include <memory>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+namespace hopi::concurrency {
+
+    /**
+     * A class implementing a fixed-size pool of worker threads.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * Create a thread pool.
+         * @param nThreads the number of worker threads
+         * @return the created thread pool
+         */
+        static std::unique_ptr<ThreadPool> create(int nThreads);
+
+        /**
+         * Constructor.
+         * @param nThreads the number of worker threads
+         */
+        explicit ThreadPool(int nThreads);
+
+        /**
+         * Destructor, wait for the tasks in the queue to be executed and join the worker threads.
+         */
+        ~ThreadPool();
+
+        /**
+         * Execute the tasks on the worker threads and wait for all of them to complete. This function can safely be
+         * called from several threads at the same time. If one of the tasks throws an exception, the exception is
+         * re-thrown by this function once all the tasks have completed.
+         * @param tasks the tasks to execute
+         */
+        void run(const std::vector<std::function<void()>> &tasks);
+
+        /**
+         * Getter.
+         * @return the number of worker threads
+         */
+        [[nodiscard]] int size() const;
+
+    private:
+        /**
+         * The function executed by each worker thread, i.e., pop and execute tasks until the pool is stopped.
+         */
+        void work();
+
+    private:
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop;
+    };
+
+}
+
+#endif //HOMING_PIGEON_THREAD_POOL_H
@@ -33,13 +33,17 @@ namespace hopi::distributions {
     }
 
     Tensor ActiveTransition::logParams() const {
-        return params().log();
+        return paramsCache()->log();
     }
 
     Tensor ActiveTransition::params() const {
         return param->detach().clone();
     }
 
+    const Tensor &ActiveTransition::paramsView() const {
+        return *param;
+    }
+
     void ActiveTransition::updateParams(const Tensor &p) {
         assert(false && "ActiveTransition::updateParams, unsupported.");
     }
@@ -49,4 +53,15 @@ namespace hopi::distributions {
         return -1;
     }
 
+    std::unique_ptr<Distribution> ActiveTransition::fork() const {
+        // The parameters of an active transition are never updated, so they can be shared without copy on write
+        return std::make_unique<ActiveTransition>(param);
+    }
+
+    void ActiveTransition::reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const {
+        report.addBytes(memory::NODE_OBJECTS, sizeof(ActiveTransition));
+        report.addTensor(category, *param);
+        reportCache(report);
+    }
+
 }
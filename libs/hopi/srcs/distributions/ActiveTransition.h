@@ -77,6 +77,12 @@ namespace hopi::distributions {
          */
         [[nodiscard]] torch::Tensor params() const override;
 
+        /**
+         * Getter.
+         * @return a read-only view of the distribution's parameters
+         */
+        [[nodiscard]] const torch::Tensor &paramsView() const override;
+
         /**
          * Update the distribution's parameters.
          * @param param the new parameters
@@ -89,6 +95,19 @@ namespace hopi::distributions {
          */
         double entropy() override;
 
+        /**
+         * Create a copy of the distribution that shares the parameters' tensor with the original.
+         * @return the copy
+         */
+        [[nodiscard]] std::unique_ptr<Distribution> fork() const override;
+
+        /**
+         * Add the memory used by the distribution to a report.
+         * @param report the report in which the memory must be added
+         * @param category the category of the parameters' tensor
+         */
+        void reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const override;
+
     private:
         std::shared_ptr<torch::Tensor> param;
     };
@@ -41,23 +41,45 @@ namespace hopi::distributions {
     }
 
     Tensor Categorical::logParams() const {
-        return params().log();
+        return paramsCache()->log();
     }
 
     Tensor Categorical::params() const {
         return param->detach().clone();
     }
 
+    const Tensor &Categorical::paramsView() const {
+        return *param;
+    }
+
     void Categorical::updateParams(const Tensor &p) {
-        assert(p.dim() == 1 && "Categorical::updateParams, input must have dimension one.");
-        *param = softmax(p, 0);
+        assert((p.dim() == 1 || p.dim() == 2) && "Categorical::updateParams, input must have dimension one or two.");
+        Tensor new_param = softmax(p, p.dim() - 1);
+        {
+            auto lock = lockParams();
+            *param = std::move(new_param);
+        }
+        updateVersion();
     }
 
     double Categorical::entropy() {
-        Tensor p = params();
+        const Tensor &p = paramsView();
         Tensor indexes = where(p != 0, true, false);
 
         return -1 * (p * logParams()).index({indexes}).sum().item<double>();
     }
 
+    std::unique_ptr<Distribution> Categorical::fork() const {
+        // The copy gets its own handle on the storage, so that the updates of either distribution do not affect
+        // the other
+        auto lock = lockParams();
+        return std::make_unique<Categorical>(std::make_shared<Tensor>(*param));
+    }
+
+    void Categorical::reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const {
+        report.addBytes(memory::NODE_OBJECTS, sizeof(Categorical));
+        report.addTensor(category, *param);
+        reportCache(report);
+    }
+
 }
@@ -36,43 +36,38 @@ namespace hopi::distributions {
     }
 
     [[nodiscard]] Tensor Dirichlet::logParams() const {
-        return params().log();
+        return paramsCache()->log();
     }
 
     [[nodiscard]] Tensor Dirichlet::params() const {
         return param->detach().clone();
     }
 
+    [[nodiscard]] const Tensor &Dirichlet::paramsView() const {
+        return *param;
+    }
+
     void Dirichlet::updateParams(const Tensor &p) {
         assert(param->dim() == p.dim() && "Dirichlet::updateParams, inputs must have the same dimensions.");
         assert(param->sizes() == p.sizes() && "Dirichlet::updateParams, inputs must have the same sizes.");
-        *param = p;
+        {
+            auto lock = lockParams();
+            *param = p;
+        }
+        updateVersion();
     }
 
-    double Dirichlet::entropy(const Tensor &&p) {
-        assert(p.dim() == 1 && "Dirichlet::entropy, input must have dimension one.");
-        auto p_a = p.accessor<double,1>();
-        double sum = 0;
-        double acc = 0;
-
-        for (int k = 0; k < p_a.size(0); ++k) {
-            acc += (p_a[k] - 1) * Ops::digamma(p_a[k]);
-            sum += p_a[k];
-        }
-        return Ops::log_beta(p) + (sum - (double) p.size(0)) * Ops::digamma(sum) - acc;
+    Tensor Dirichlet::logBeta(const Tensor &p) {
+        return Ops::log_gamma(p).sum(-1) - Ops::log_gamma(p.sum(-1));
     }
 
     double Dirichlet::entropy() {
-        double e = 0;
-
-        Ops::unsqueeze(3 - param->dim(), {param.get()});
-        for (int i = 0; i < param->size(0); ++i) {
-            for (int j = 0; j < param->size(1); ++j) {
-                e += entropy(param->index({i, j, Ellipsis}));
-            }
-        }
-        *param = torch::squeeze(*param);
-        return e;
+        // The entropy of each Dirichlet along the last dimension is computed in one pass, then summed
+        const Tensor &p = *param;
+        Tensor sums = p.sum(-1);
+        auto k = (double) p.size(-1);
+        Tensor e = logBeta(p) + (sums - k) * Ops::digamma(sums) - ((p - 1) * Ops::digamma(p)).sum(-1);
+        return e.sum().item<double>();
     }
 
     Tensor Dirichlet::expectation(const Tensor &p) {
@@ -92,19 +87,26 @@ namespace hopi::distributions {
         // Make sure input are valid
         assert(p.dim() <= 3 && "Dirichlet::expectedLog does not support Dirichlet of dimension superior to three");
 
-        // Compute the expected log
-        Tensor m = p.detach().clone();
+        // Compute the expected log of all the Dirichlet along the last dimension at once
+        Tensor m = p.detach();
+        return Ops::digamma(m) - Ops::digamma(m.sum(-1, true));
+    }
 
-        Ops::unsqueeze(3 - m.dim(), {&m});
-        for (int i = 0; i < m.size(0); ++i) {
-            for (int j = 0; j < m.size(1); ++j) {
-                auto sum = m.index({i,j,Ellipsis}).sum().item<double>();
-                for (int k = 0; k < m.size(2); ++k) {
-                    m[i][j][k] = Ops::digamma(m[i][j][k].item<double>()) - Ops::digamma(sum);
-                }
-            }
-        }
-        return torch::squeeze(m);
+    Tensor Dirichlet::expectedLog() const {
+        return paramsCache()->expectedLog();
+    }
+
+    std::unique_ptr<Distribution> Dirichlet::fork() const {
+        // The copy gets its own handle on the storage, so that the updates of either distribution do not affect
+        // the other
+        auto lock = lockParams();
+        return std::make_unique<Dirichlet>(std::make_shared<Tensor>(*param));
+    }
+
+    void Dirichlet::reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const {
+        report.addBytes(memory::NODE_OBJECTS, sizeof(Dirichlet));
+        report.addTensor(category, *param);
+        reportCache(report);
     }
 
 }
@@ -77,6 +77,12 @@ namespace hopi::distributions {
          */
         [[nodiscard]] torch::Tensor params() const override;
 
+        /**
+         * Getter.
+         * @return a read-only view of the distribution's parameters
+         */
+        [[nodiscard]] const torch::Tensor &paramsView() const override;
+
         /**
          * Update the distribution's parameters.
          * @param param the new parameters
@@ -89,6 +95,19 @@ namespace hopi::distributions {
          */
         double entropy() override;
 
+        /**
+         * Create a copy of the distribution that shares the parameters' storage with the original.
+         * @return the copy
+         */
+        [[nodiscard]] std::unique_ptr<Distribution> fork() const override;
+
+        /**
+         * Add the memory used by the distribution to a report.
+         * @param report the report in which the memory must be added
+         * @param category the category of the parameters' tensor
+         */
+        void reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const override;
+
     public:
         /**
          * Compute the expectation of the logarithm of x
@@ -97,6 +116,13 @@ namespace hopi::distributions {
          */
         static torch::Tensor expectedLog(const torch::Tensor &p);
 
+        /**
+         * Compute the expectation of the logarithm of x, where x is distributed according to this Dirichlet. The
+         * result is cached until the parameters are updated, and must therefore not be modified in place.
+         * @return the expectation of the logarithm of x
+         */
+        [[nodiscard]] torch::Tensor expectedLog() const;
+
         /**
          * Compute the expectation of X where X is a vector distributed according to a Dirichlet distribution
          * @param p the parameter of the Dirichlet
@@ -104,13 +130,12 @@ namespace hopi::distributions {
          */
         static torch::Tensor expectation(const torch::Tensor &p);
 
-    private:
         /**
-         * Compute the entropy of a 1D Dirichlet whose parameters are given by "p".
-         * @param p the parameters of a 1D Dirichlet
-         * @return the entropy of the Dirichlet
+         * Compute the logarithm of the multivariate beta function of each Dirichlet along the last dimension of "p".
+         * @param p the parameters of the Dirichlet distributions
+         * @return the logarithm of the beta functions, i.e., a tensor with one dimension less than "p"
          */
-        static double entropy(const torch::Tensor &&p);
+        static torch::Tensor logBeta(const torch::Tensor &p);
 
     private:
         std::shared_ptr<torch::Tensor> param;
@@ -0,0 +1,39 @@
+#include "Distribution.h"
+
+namespace hopi::distributions {
+
+    std::atomic<long> Distribution::lastVersion(0);
+
+    Distribution::Distribution() : _version(++lastVersion) {}
+
+    long Distribution::version() const {
+        return _version;
+    }
+
+    void Distribution::updateVersion() {
+        _version = ++lastVersion;
+        std::atomic_store(&_cache, std::shared_ptr<ParamsCache>());
+    }
+
+    std::shared_ptr<ParamsCache> Distribution::paramsCache() const {
+        // The cache may be requested concurrently by all the factors that share the distribution
+        auto cache = std::atomic_load(&_cache);
+        if (cache == nullptr || !cache->caches(paramsView())) {
+            cache = ParamsCache::of(paramsView());
+            std::atomic_store(&_cache, cache);
+        }
+        return cache;
+    }
+
+    void Distribution::reportCache(memory::MemoryReport &report) const {
+        auto cache = std::atomic_load(&_cache);
+        if (cache != nullptr) {
+            cache->reportMemory(report);
+        }
+    }
+
+    std::unique_lock<std::mutex> Distribution::lockParams() const {
+        return std::unique_lock<std::mutex>(_params_mutex);
+    }
+
+}
@@ -6,16 +6,39 @@
 #define HOMING_PIGEON_DISTRIBUTION_H
 
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <torch/torch.h>
 #include "DistributionType.h"
+#include "ParamsCache.h"
+#include "memory/PoolAllocator.h"
+#include "memory/MemoryReport.h"
 
 namespace hopi::distributions {
 
     /**
      * Interface representing a general probability distribution.
      */
-    class Distribution {
+    class Distribution : public memory::PoolAllocated {
     public:
+        /**
+         * Constructor.
+         */
+        Distribution();
+
+        /**
+         * Destructor.
+         */
+        virtual ~Distribution() = default;
+
+        /**
+         * Getter.
+         * @return the distribution's version, i.e., a number that is unique across all distributions and which
+         * changes every time the distribution's parameters are updated
+         */
+        [[nodiscard]] long version() const;
+
         /**
          * Getter.
          * @return the distribution's type
@@ -24,16 +47,25 @@ namespace hopi::distributions {
 
         /**
          * Getter.
-         * @return the logarithm of the distribution's parameters
+         * @return the logarithm of the distribution's parameters, which is cached until the parameters are updated and
+         * must therefore not be modified in place
          */
         [[nodiscard]] virtual torch::Tensor logParams() const = 0;
 
         /**
          * Getter.
-         * @return the distribution's parameters
+         * @return a copy of the distribution's parameters, which can be modified by the caller
          */
         [[nodiscard]] virtual torch::Tensor params() const = 0;
 
+        /**
+         * Getter.
+         * @return a read-only view of the distribution's parameters, which shares its storage with the distribution
+         * and must therefore not be modified in place. Since updates never modify the parameters in place, a copy of
+         * the returned tensor keeps the old parameters after an update.
+         */
+        [[nodiscard]] virtual const torch::Tensor &paramsView() const = 0;
+
         /**
          * Update the distribution's parameters.
          * @param param the new parameters
@@ -45,6 +77,55 @@ namespace hopi::distributions {
          * @return the entropy
          */
         virtual double entropy() = 0;
+
+        /**
+         * Create a copy of the distribution that shares the parameters' storage with the original. The copy holds its
+         * own handle on the storage, and the updates replace the handle of the updated distribution instead of writing
+         * into the storage, i.e., the storage is copied on write. The fork can be taken by a thread while the owner of
+         * the distribution updates it.
+         * @return the copy
+         */
+        [[nodiscard]] virtual std::unique_ptr<Distribution> fork() const = 0;
+
+        /**
+         * Add the memory used by the distribution to a report.
+         * @param report the report in which the memory must be added
+         * @param category the category of the parameters' tensor
+         */
+        virtual void reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const = 0;
+
+    protected:
+        /**
+         * Lock the handle of the parameters' tensor, the lock must be held while an update replaces the handle and
+         * while a fork copies it.
+         * @return the lock
+         */
+        [[nodiscard]] std::unique_lock<std::mutex> lockParams() const;
+
+    protected:
+        /**
+         * Notify that the distribution's parameters have been updated, i.e., give a new version to the distribution
+         * and drop the cache of the old parameters.
+         */
+        void updateVersion();
+
+        /**
+         * Getter.
+         * @return the cache of the tensors derived from the distribution's parameters
+         */
+        [[nodiscard]] std::shared_ptr<ParamsCache> paramsCache() const;
+
+        /**
+         * Add the memory used by the cache of the distribution's parameters to a report, if the cache exists.
+         * @param report the report in which the memory must be added
+         */
+        void reportCache(memory::MemoryReport &report) const;
+
+    private:
+        static std::atomic<long> lastVersion;
+        long _version;
+        mutable std::mutex _params_mutex;
+        mutable std::shared_ptr<ParamsCache> _cache;
     };
 
 }
@@ -0,0 +1,63 @@
+#include "ParamsCache.h"
+#include "Dirichlet.h"
+
+using namespace torch;
+
+namespace hopi::distributions {
+
+    std::mutex ParamsCache::registryMutex;
+
+    std::unordered_map<const void*, std::weak_ptr<ParamsCache>> ParamsCache::registry;
+
+    std::size_t ParamsCache::purgeSize = 64;
+
+    std::shared_ptr<ParamsCache> ParamsCache::of(const Tensor &param) {
+        std::unique_lock<std::mutex> lock(registryMutex);
+
+        // A live cache keeps its parameters alive, so its key cannot have been reused by other parameters
+        auto &entry = registry[param.unsafeGetTensorImpl()];
+        auto cache = entry.lock();
+        if (cache == nullptr) {
+            cache = std::make_shared<ParamsCache>(param);
+            entry = cache;
+        }
+
+        // Remove the caches that are no longer used by any distribution
+        if (registry.size() >= purgeSize) {
+            for (auto it = registry.begin(); it != registry.end();) {
+                it = it->second.expired() ? registry.erase(it) : std::next(it);
+            }
+            purgeSize = std::max(purgeSize, 2 * registry.size());
+        }
+        return cache;
+    }
+
+    ParamsCache::ParamsCache(const Tensor &param) : _param(param) {}
+
+    bool ParamsCache::caches(const Tensor &param) const {
+        return _param.is_same(param);
+    }
+
+    Tensor ParamsCache::log() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_log.defined()) {
+            _log = _param.log();
+        }
+        return _log;
+    }
+
+    Tensor ParamsCache::expectedLog() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_expected_log.defined()) {
+            _expected_log = Dirichlet::expectedLog(_param);
+        }
+        return _expected_log;
+    }
+
+    void ParamsCache::reportMemory(memory::MemoryReport &report) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        report.addTensor(memory::MESSAGE_CACHES, _log);
+        report.addTensor(memory::MESSAGE_CACHES, _expected_log);
+    }
+
+}
@@ -0,0 +1,72 @@
+#ifndef HOMING_PIGEON_PARAMS_CACHE_H
+#define HOMING_PIGEON_PARAMS_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <torch/torch.h>
+#include "memory/MemoryReport.h"
+
+namespace hopi::distributions {
+
+    /**
+     * A class caching the tensors derived from the parameters of a distribution, i.e., their logarithm and the
+     * expectation of their logarithm under a Dirichlet. The cache is shared by all the distributions whose parameters
+     * are the same tensor, e.g., the likelihood distributions of all the time slices. Since the distributions never
+     * modify their parameters in place, the cache becomes invalid as soon as the parameters are updated.
+     */
+    class ParamsCache {
+    public:
+        /**
+         * Getter.
+         * @param param the parameters whose cache must be returned
+         * @return the cache shared by all the distributions whose parameters are "param", which is created if needed
+         */
+        static std::shared_ptr<ParamsCache> of(const torch::Tensor &param);
+
+        /**
+         * Constructor.
+         * @param param the parameters whose derived tensors are cached
+         */
+        explicit ParamsCache(const torch::Tensor &param);
+
+        /**
+         * Check whether the cache stores the tensors derived from some parameters.
+         * @param param the parameters
+         * @return true if the cache is the cache of the parameters, false otherwise
+         */
+        [[nodiscard]] bool caches(const torch::Tensor &param) const;
+
+        /**
+         * Getter.
+         * @return the logarithm of the parameters, which is computed on the first call
+         */
+        torch::Tensor log();
+
+        /**
+         * Getter.
+         * @return the expectation of the logarithm of a vector distributed according to a Dirichlet whose parameters
+         * are cached, which is computed on the first call
+         */
+        torch::Tensor expectedLog();
+
+        /**
+         * Add the memory used by the cached tensors to a report.
+         * @param report the report in which the memory must be added
+         */
+        void reportMemory(memory::MemoryReport &report);
+
+    private:
+        torch::Tensor _param;
+        torch::Tensor _log;
+        torch::Tensor _expected_log;
+        std::mutex _mutex;
+
+        static std::mutex registryMutex;
+        static std::unordered_map<const void*, std::weak_ptr<ParamsCache>> registry;
+        static std::size_t purgeSize;
+    };
+
+}
+
+#endif //HOMING_PIGEON_PARAMS_CACHE_H
@@ -33,13 +33,17 @@ namespace hopi::distributions {
     }
 
     Tensor Transition::logParams() const {
-        return params().log();
+        return paramsCache()->log();
     }
 
     Tensor Transition::params() const {
         return param->detach().clone();
     }
 
+    const Tensor &Transition::paramsView() const {
+        return *param;
+    }
+
     void Transition::updateParams(const Tensor &p) {
         assert(false && "Transition::updateParams, unsupported.");
     }
@@ -48,4 +52,15 @@ namespace hopi::distributions {
         assert(false && "Transition::entropy, unsupported.");
     }
 
+    std::unique_ptr<Distribution> Transition::fork() const {
+        // The parameters of a transition are never updated, so they can be shared without copy on write
+        return std::make_unique<Transition>(param);
+    }
+
+    void Transition::reportMemory(memory::MemoryReport &report, const memory::MemoryCategory &category) const {
+        report.addBytes(memory::NODE_OBJECTS, sizeof(Transition));
+        report.addTensor(category, *param);
+        reportCache(report);
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,555 @@
+#include "Checkpoint.h"
+#include "FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Categorical.h"
+#include "distributions/Transition.h"
+#include "distributions/ActiveTransition.h"
+#include "distributions/Dirichlet.h"
+#include "algorithms/planning/MCTSNodeData.h"
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <string_view>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace hopi::nodes;
+using namespace hopi::distributions;
+using namespace torch;
+
+namespace hopi::graphs {
+
+    //
+    // The records of the checkpoint's tables, all fields are naturally aligned so that the tables can be read in
+    // place from the memory mapping.
+    //
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::int64_t batch_size;
+        std::int32_t window_size;
+        std::int32_t root;
+        std::int32_t n_vars;
+        std::int32_t n_factors;
+        std::int32_t n_tensors;
+        std::int32_t n_children;
+        std::int32_t n_dirty;
+        std::int32_t n_extras;
+        std::int64_t strings_size;
+        std::int64_t blob_offset;
+        std::int64_t blob_size;
+    };
+
+    struct DistributionRecord {
+        std::int32_t type;   // The distribution's type, or -1 if the distribution is nullptr
+        std::int32_t tensor; // The index of the distribution's parameters in the tensor table
+    };
+
+    struct VarRecord {
+        std::int32_t type;
+        std::int32_t parent;
+        std::int64_t name_offset;
+        std::int32_t name_size;
+        std::int32_t first_child;
+        std::int32_t n_children;
+        std::int32_t visits;
+        double cost;
+        std::int32_t action;
+        std::int32_t pruned;
+        DistributionRecord prior;
+        DistributionRecord posterior;
+        DistributionRecord biased;
+    };
+
+    struct FactorRecord {
+        std::int32_t type;
+        std::int32_t child;
+        std::int32_t parents[3];
+        std::int32_t padding;
+    };
+
+    struct TensorRecord {
+        std::int64_t offset;
+        std::int64_t n_bytes;
+        std::int32_t dtype;
+        std::int32_t n_dims;
+        std::int64_t sizes[Checkpoint::MAX_DIMS];
+    };
+
+    struct ExtraRecord {
+        std::int64_t name_offset;
+        std::int32_t name_size;
+        std::int32_t tensor;
+    };
+
+    /**
+     * A read-only view of a file mapped in memory, the mapping is released when the object is destroyed.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &file_name) : _data(nullptr), _size(0) {
+#ifdef _WIN32
+            std::ifstream file(file_name, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("In Checkpoint::load, cannot open: '" + file_name + "'");
+            }
+            _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            _data = _buffer.data();
+            _size = _buffer.size();
+#else
+            int fd = open(file_name.c_str(), O_RDONLY);
+            struct stat info{};
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                if (fd >= 0) close(fd);
+                throw std::runtime_error("In Checkpoint::load, cannot open: '" + file_name + "'");
+            }
+            _size = (std::size_t) info.st_size;
+            if (_size != 0) {
+                // A private mapping, writes performed on the tensors are never propagated to the file
+                void *data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("In Checkpoint::load, cannot map: '" + file_name + "'");
+                }
+                _data = static_cast<char*>(data);
+            }
+            close(fd);
+#endif
+        }
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if (_data != nullptr) {
+                munmap(_data, _size);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        [[nodiscard]] char *data() const { return _data; }
+        [[nodiscard]] std::size_t size() const { return _size; }
+
+    private:
+        char *_data;
+        std::size_t _size;
+#ifdef _WIN32
+        std::vector<char> _buffer;
+#endif
+    };
+
+    /**
+     * Compute the position of the end of the tables, i.e., the position of the first byte after the strings.
+     * @param header the header of the checkpoint
+     * @return the position of the end of the tables
+     */
+    static std::int64_t tablesEnd(const Header &header) {
+        return (std::int64_t) sizeof(Header) +
+            header.n_vars * (std::int64_t) sizeof(VarRecord) +
+            header.n_factors * (std::int64_t) sizeof(FactorRecord) +
+            header.n_tensors * (std::int64_t) sizeof(TensorRecord) +
+            header.n_extras * (std::int64_t) sizeof(ExtraRecord) +
+            (header.n_children + (std::int64_t) header.n_dirty) * (std::int64_t) sizeof(std::int32_t) +
+            header.strings_size;
+    }
+
+    /**
+     * Getter.
+     * @param dtype the type of the elements of a tensor, as stored in the tensor table
+     * @return the size of the elements in bytes, or zero if the type is not supported
+     */
+    static std::int64_t elementSize(std::int32_t dtype) {
+        switch ((ScalarType) dtype) {
+            case ScalarType::Bool:
+            case ScalarType::Byte:
+            case ScalarType::Char:
+                return 1;
+            case ScalarType::Short:
+            case ScalarType::Half:
+            case ScalarType::BFloat16:
+                return 2;
+            case ScalarType::Int:
+            case ScalarType::Float:
+                return 4;
+            case ScalarType::Long:
+            case ScalarType::Double:
+                return 8;
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * A class building the tensor table and the tensor blob of a checkpoint, identical tensors are stored once.
+     */
+    class TensorTable {
+    public:
+        int add(const Tensor &tensor) {
+            Tensor t = tensor.detach().to(kCPU).contiguous();
+            if (t.dim() > Checkpoint::MAX_DIMS) {
+                throw std::runtime_error("In Checkpoint::save, tensors cannot have more than 8 dimensions.");
+            }
+            auto n_bytes = (std::int64_t) t.nbytes();
+            auto bytes = static_cast<const char*>(t.data_ptr());
+
+            // Look for an identical tensor
+            std::size_t key = std::hash<std::string_view>{}(std::string_view(bytes, n_bytes));
+            for (int index : _buckets[key]) {
+                const TensorRecord &r = _records[index];
+                if (r.dtype == (std::int32_t) t.scalar_type() && r.n_dims == t.dim() &&
+                    std::equal(t.sizes().begin(), t.sizes().end(), r.sizes) &&
+                    r.n_bytes == n_bytes && std::memcmp(_blob.data() + r.offset, bytes, n_bytes) == 0) {
+                    return index;
+                }
+            }
+
+            // Append the tensor to the blob
+            TensorRecord record{};
+            record.offset = (std::int64_t) _blob.size();
+            record.n_bytes = n_bytes;
+            record.dtype = (std::int32_t) t.scalar_type();
+            record.n_dims = (std::int32_t) t.dim();
+            for (int i = 0; i < t.dim(); ++i) {
+                record.sizes[i] = t.size(i);
+            }
+            _blob.insert(_blob.end(), bytes, bytes + n_bytes);
+            _blob.resize((_blob.size() + Checkpoint::ALIGNMENT - 1) / Checkpoint::ALIGNMENT * Checkpoint::ALIGNMENT);
+            _records.push_back(record);
+            _buckets[key].push_back((int) _records.size() - 1);
+            return (int) _records.size() - 1;
+        }
+
+        [[nodiscard]] const std::vector<TensorRecord> &records() const { return _records; }
+        [[nodiscard]] const std::vector<char> &blob() const { return _blob; }
+
+    private:
+        std::vector<TensorRecord> _records;
+        std::vector<char> _blob;
+        std::unordered_map<std::size_t, std::vector<int>> _buckets;
+    };
+
+    /**
+     * Write the content of a vector in a stream.
+     * @tparam T the type of the vector's elements
+     * @param file the output stream
+     * @param data the vector to write
+     */
+    template<class T>
+    static void write(std::ofstream &file, const std::vector<T> &data) {
+        file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize) (data.size() * sizeof(T)));
+    }
+
+    /**
+     * Create the record of a distribution.
+     * @param d the distribution
+     * @param tensors the tensor table of the checkpoint
+     * @return the record
+     */
+    static DistributionRecord record(Distribution *d, TensorTable &tensors) {
+        if (d == nullptr) {
+            return DistributionRecord{-1, -1};
+        }
+        return DistributionRecord{(std::int32_t) d->type(), tensors.add(d->paramsView())};
+    }
+
+    void Checkpoint::save(const std::string &file_name, FactorGraph *fg, const std::map<std::string, Tensor> &tensors) {
+        std::vector<VarNode*> vars = fg->getNodes();
+        std::unordered_map<const VarNode*, int> var_indices;
+        std::unordered_map<const FactorNode*, int> factor_indices;
+        for (int i = 0; i < (int) vars.size(); ++i) {
+            var_indices[vars[i]] = i;
+        }
+        for (int i = 0; i < fg->factors(); ++i) {
+            factor_indices[fg->factor(i)] = i;
+        }
+        auto var_index = [&var_indices](const VarNode *var) {
+            auto it = var_indices.find(var);
+            return (it == var_indices.end()) ? -1 : it->second;
+        };
+
+        // Create the tables
+        TensorTable tensor_table;
+        std::string strings;
+        std::vector<VarRecord> var_records;
+        std::vector<FactorRecord> factor_records;
+        std::vector<std::int32_t> children;
+        std::vector<std::int32_t> dirty;
+        std::vector<ExtraRecord> extras;
+        for (auto var : vars) {
+            VarRecord r{};
+            r.type = var->type();
+            r.parent = (var->parent() == nullptr) ? -1 : factor_indices[var->parent()];
+            r.name_offset = (std::int64_t) strings.size();
+            r.name_size = (std::int32_t) var->name().size();
+            strings += var->name();
+            r.first_child = (std::int32_t) children.size();
+            for (auto it = var->firstChild(); it != var->lastChild(); ++it) {
+                if (*it != nullptr) {
+                    children.push_back(factor_indices[*it]);
+                }
+            }
+            r.n_children = (std::int32_t) children.size() - r.first_child;
+            auto &data = var->dataOrDefault();
+            r.visits = data.visits;
+            r.cost = data.cost;
+            r.action = data.action;
+            r.pruned = data.pruned;
+            r.prior = record(var->prior(), tensor_table);
+            r.posterior = record(var->posterior(), tensor_table);
+            r.biased = record(var->biased(), tensor_table);
+            var_records.push_back(r);
+        }
+        for (int i = 0; i < fg->factors(); ++i) {
+            FactorNode *factor = fg->factor(i);
+            FactorRecord r{};
+            r.type = factor->type();
+            r.child = var_index(factor->child());
+            for (int j = 0; j < 3; ++j) {
+                r.parents[j] = var_index(factor->parent(j));
+            }
+            factor_records.push_back(r);
+        }
+        for (auto var : fg->dirtyNodes()) {
+            dirty.push_back(var_index(var));
+        }
+        for (auto &entry : tensors) {
+            extras.push_back(ExtraRecord{(std::int64_t) strings.size(), (std::int32_t) entry.first.size(), tensor_table.add(entry.second)});
+            strings += entry.first;
+        }
+
+        // Fill in the header
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.header_size = sizeof(Header);
+        header.batch_size = fg->batchSize();
+        header.window_size = fg->windowSize();
+        header.root = var_index(fg->treeRoot());
+        header.n_vars = (std::int32_t) var_records.size();
+        header.n_factors = (std::int32_t) factor_records.size();
+        header.n_tensors = (std::int32_t) tensor_table.records().size();
+        header.n_children = (std::int32_t) children.size();
+        header.n_dirty = (std::int32_t) dirty.size();
+        header.n_extras = (std::int32_t) extras.size();
+        header.strings_size = (std::int64_t) strings.size();
+        std::int64_t tables_end = tablesEnd(header);
+        header.blob_offset = (tables_end + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        header.blob_size = (std::int64_t) tensor_table.blob().size();
+
+        // Write the checkpoint
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("In Checkpoint::save, cannot open: '" + file_name + "'");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        write(file, var_records);
+        write(file, factor_records);
+        write(file, tensor_table.records());
+        write(file, extras);
+        write(file, children);
+        write(file, dirty);
+        file.write(strings.data(), (std::streamsize) strings.size());
+        write(file, std::vector<char>(header.blob_offset - tables_end, 0));
+        write(file, tensor_table.blob());
+        if (!file.good()) {
+            throw std::runtime_error("In Checkpoint::save, cannot write: '" + file_name + "'");
+        }
+    }
+
+    /**
+     * Create a distribution from its record.
+     * @param r the distribution's record
+     * @param tensors the tensors of the checkpoint
+     * @return the distribution
+     */
+    static std::unique_ptr<Distribution> distribution(const DistributionRecord &r, const std::vector<Tensor> &tensors) {
+        if (r.type < 0) {
+            return nullptr;
+        }
+        if (r.tensor < 0 || r.tensor >= (int) tensors.size()) {
+            throw std::runtime_error("In Checkpoint::load, invalid tensor index.");
+        }
+        switch (r.type) {
+            case DistributionType::CATEGORICAL:
+                return Categorical::create(tensors[r.tensor]);
+            case DistributionType::TRANSITION:
+                return Transition::create(tensors[r.tensor]);
+            case DistributionType::ACTIVE_TRANSITION:
+                return ActiveTransition::create(tensors[r.tensor]);
+            case DistributionType::DIRICHLET:
+                return Dirichlet::create(tensors[r.tensor]);
+            default:
+                throw std::runtime_error("In Checkpoint::load, unsupported distribution type.");
+        }
+    }
+
+    std::shared_ptr<FactorGraph> Checkpoint::load(const std::string &file_name, std::map<std::string, Tensor> *tensors) {
+        auto file = std::make_shared<MappedFile>(file_name);
+
+        // Check the header
+        if (file->size() < sizeof(Header)) {
+            throw std::runtime_error("In Checkpoint::load, invalid file: '" + file_name + "'");
+        }
+        const auto *header = reinterpret_cast<const Header*>(file->data());
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("In Checkpoint::load, not a checkpoint: '" + file_name + "'");
+        }
+        if (header->version != VERSION || header->header_size != sizeof(Header)) {
+            throw std::runtime_error("In Checkpoint::load, unsupported version: '" + file_name + "'");
+        }
+        auto file_size = (std::int64_t) file->size();
+        if (header->n_vars < 0 || header->n_factors < 0 || header->n_tensors < 0 || header->n_children < 0 ||
+            header->n_dirty < 0 || header->n_extras < 0 || header->strings_size < 0 ||
+            header->strings_size > file_size || header->blob_offset < 0 || header->blob_size < 0 ||
+            header->blob_offset > file_size || header->blob_size > file_size - header->blob_offset ||
+            tablesEnd(*header) > header->blob_offset) {
+            throw std::runtime_error("In Checkpoint::load, truncated file: '" + file_name + "'");
+        }
+
+        // Locate the tables
+        const char *ptr = file->data() + sizeof(Header);
+        const auto *var_records = reinterpret_cast<const VarRecord*>(ptr);
+        ptr += header->n_vars * sizeof(VarRecord);
+        const auto *factor_records = reinterpret_cast<const FactorRecord*>(ptr);
+        ptr += header->n_factors * sizeof(FactorRecord);
+        const auto *tensor_records = reinterpret_cast<const TensorRecord*>(ptr);
+        ptr += header->n_tensors * sizeof(TensorRecord);
+        const auto *extras = reinterpret_cast<const ExtraRecord*>(ptr);
+        ptr += header->n_extras * sizeof(ExtraRecord);
+        const auto *children = reinterpret_cast<const std::int32_t*>(ptr);
+        ptr += header->n_children * sizeof(std::int32_t);
+        const auto *dirty = reinterpret_cast<const std::int32_t*>(ptr);
+        ptr += header->n_dirty * sizeof(std::int32_t);
+        const char *strings = ptr;
+        char *blob = file->data() + header->blob_offset;
+
+        // Create the tensors, which point into the mapping and keep it alive
+        std::vector<Tensor> blob_tensors;
+        for (int i = 0; i < header->n_tensors; ++i) {
+            const TensorRecord &r = tensor_records[i];
+            std::int64_t element_size = elementSize(r.dtype);
+            bool valid = element_size != 0 && r.n_dims >= 0 && r.n_dims <= MAX_DIMS &&
+                r.offset >= 0 && r.offset % element_size == 0 && r.n_bytes >= 0 &&
+                r.offset <= header->blob_size && r.n_bytes <= header->blob_size - r.offset;
+
+            // The number of bytes must match the tensor's shape, the number of elements is bounded by the size of
+            // the blob so that the product of the sizes cannot overflow
+            std::int64_t n_elements = 1;
+            for (int j = 0; valid && j < r.n_dims; ++j) {
+                valid = r.sizes[j] >= 0 && (r.sizes[j] == 0 || n_elements <= header->blob_size / r.sizes[j]);
+                n_elements *= valid ? r.sizes[j] : 1;
+            }
+            if (!valid || n_elements * element_size != r.n_bytes) {
+                throw std::runtime_error("In Checkpoint::load, invalid tensor: '" + file_name + "'");
+            }
+            std::vector<std::int64_t> sizes(r.sizes, r.sizes + r.n_dims);
+            auto options = TensorOptions().dtype((ScalarType) r.dtype);
+            blob_tensors.push_back(from_blob(blob + r.offset, sizes, [file](void *) {}, options));
+        }
+        auto string = [strings, header, &file_name](std::int64_t offset, std::int32_t size) {
+            if (offset < 0 || size < 0 || offset > header->strings_size || size > header->strings_size - offset) {
+                throw std::runtime_error("In Checkpoint::load, invalid string: '" + file_name + "'");
+            }
+            return std::string(strings + offset, size);
+        };
+        auto check = [&file_name](std::int32_t index, std::int32_t size) {
+            if (index < -1 || index >= size) {
+                throw std::runtime_error("In Checkpoint::load, invalid index: '" + file_name + "'");
+            }
+            return index;
+        };
+
+        // Create the variables
+        auto fg = std::make_shared<FactorGraph>();
+        fg->setBatchSize(header->batch_size);
+        fg->setWindowSize(header->window_size);
+        std::vector<VarNode*> vars;
+        std::vector<FactorNode*> factors;
+        for (int i = 0; i < header->n_vars; ++i) {
+            const VarRecord &r = var_records[i];
+            if (r.type != VarNodeType::OBSERVED && r.type != VarNodeType::HIDDEN) {
+                throw std::runtime_error("In Checkpoint::load, invalid variable type: '" + file_name + "'");
+            }
+            VarNode *var = fg->addNode(VarNode::create((VarNodeType) r.type));
+            var->setName(string(r.name_offset, r.name_size));
+            var->setPrior(distribution(r.prior, blob_tensors));
+            var->setPosterior(distribution(r.posterior, blob_tensors));
+            var->setBiased(distribution(r.biased, blob_tensors));
+            auto &defaults = var->dataOrDefault();
+            if (r.visits != defaults.visits || r.cost != defaults.cost ||
+                r.action != defaults.action || r.pruned != defaults.pruned) {
+                var->data()->visits = r.visits;
+                var->data()->cost = r.cost;
+                var->data()->action = r.action;
+                var->data()->pruned = r.pruned;
+            }
+            vars.push_back(var);
+        }
+        auto var = [&vars, &check](std::int32_t index) {
+            index = check(index, (std::int32_t) vars.size());
+            return (index == -1) ? nullptr : vars[index];
+        };
+        auto factor = [&factors, &file_name](std::int32_t index) {
+            if (index < 0 || index >= (std::int32_t) factors.size()) {
+                throw std::runtime_error("In Checkpoint::load, invalid index: '" + file_name + "'");
+            }
+            return factors[index];
+        };
+
+        // Create the factors, then connect the variables to them
+        for (int i = 0; i < header->n_factors; ++i) {
+            const FactorRecord &r = factor_records[i];
+            if (r.type < FactorNodeType::CATEGORICAL_NODE || r.type > FactorNodeType::DIRICHLET_NODE) {
+                throw std::runtime_error("In Checkpoint::load, invalid factor type: '" + file_name + "'");
+            }
+            if (r.child == -1) {
+                throw std::runtime_error("In Checkpoint::load, factor without child: '" + file_name + "'");
+            }
+            std::vector<VarNode*> parents{var(r.parents[0]), var(r.parents[1]), var(r.parents[2])};
+            factors.push_back(fg->addFactor(FactorGraph::createFactor((FactorNodeType) r.type, var(r.child), parents)));
+        }
+        for (int i = 0; i < header->n_vars; ++i) {
+            const VarRecord &r = var_records[i];
+            if (r.parent != -1) {
+                vars[i]->setParent(factor(r.parent));
+            }
+            if (r.first_child < 0 || r.n_children < 0 || r.first_child + r.n_children > header->n_children) {
+                throw std::runtime_error("In Checkpoint::load, invalid children: '" + file_name + "'");
+            }
+            for (int j = r.first_child; j < r.first_child + r.n_children; ++j) {
+                vars[i]->addChild(factor(children[j]));
+            }
+        }
+
+        // Restore the tree's root, the dirty nodes and the extra tensors
+        fg->setTreeRoot(var(header->root));
+        fg->clearDirty();
+        for (int i = 0; i < header->n_dirty; ++i) {
+            if (dirty[i] != -1) {
+                fg->markDirty(var(dirty[i]));
+            }
+        }
+        if (tensors != nullptr) {
+            for (int i = 0; i < header->n_extras; ++i) {
+                // Unlike the other indices, the index of an extra tensor cannot be null (i.e., -1)
+                if (extras[i].tensor < 0 || extras[i].tensor >= header->n_tensors) {
+                    throw std::runtime_error("In Checkpoint::load, invalid index: '" + file_name + "'");
+                }
+                (*tensors)[string(extras[i].name_offset, extras[i].name_size)] = blob_tensors[extras[i].tensor];
+            }
+        }
+        return fg;
+    }
+
+}
@@ -0,0 +1,60 @@
+#ifndef HOMING_PIGEON_CHECKPOINT_H
+#define HOMING_PIGEON_CHECKPOINT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+
+namespace hopi::graphs {
+
+    class FactorGraph;
+
+    /**
+     * A class saving and loading factor graphs in a versioned binary format. A checkpoint is made of:
+     *  - a fixed size header (magic number, format version, and the size of each table);
+     *  - a flat table of variable nodes, a flat table of factor nodes and a table of tensors, whose entries refer
+     *    to each other by index;
+     *  - the children of each variable node, the dirty nodes, and the names of the nodes and of the extra tensors;
+     *  - a single contiguous blob containing the data of all the tensors, in which identical tensors are stored
+     *    only once.
+     * Integers and floating point numbers are written in the byte order of the machine. When loading a checkpoint,
+     * the file is mapped in memory and the tensors of the distributions directly point into the mapping, i.e., the
+     * tensor data is never copied.
+     */
+    class Checkpoint {
+    public:
+        /**
+         * Write a factor graph in a file. A std::runtime_error is thrown, before the file is opened, if one of the
+         * tensors has more than MAX_DIMS dimensions.
+         * @param file_name the name of the file
+         * @param fg the factor graph to save
+         * @param tensors extra tensors to save along with the graph (e.g., the model of an agent), indexed by name
+         */
+        static void save(
+                const std::string &file_name,
+                FactorGraph *fg,
+                const std::map<std::string, torch::Tensor> &tensors = {}
+        );
+
+        /**
+         * Load a factor graph from a file.
+         * @param file_name the name of the file
+         * @param tensors if not nullptr, the extra tensors saved along with the graph are written in this map
+         * @return the loaded factor graph
+         */
+        static std::shared_ptr<FactorGraph> load(
+                const std::string &file_name,
+                std::map<std::string, torch::Tensor> *tensors = nullptr
+        );
+
+    public:
+        static constexpr char MAGIC[8] = {'H', 'O', 'P', 'I', 'C', 'K', 'P', 'T'};
+        static constexpr std::uint32_t VERSION = 1;
+        static constexpr int MAX_DIMS = 8;
+        static constexpr std::int64_t ALIGNMENT = 64;
+    };
+
+}
+
+#endif //HOMING_PIGEON_CHECKPOINT_H
@@ -6,15 +6,17 @@
 #include "distributions/Categorical.h"
 #include "nodes/VarNode.h"
 #include "nodes/FactorNode.h"
+#include "nodes/CategoricalNode.h"
+#include "nodes/TransitionNode.h"
+#include "nodes/ActiveTransitionNode.h"
+#include "nodes/DirichletNode.h"
 #include "math/Ops.h"
 #include "api/API.h"
 #include "FactorGraph.h"
 #include "GraphViz.h"
-#include "iterators/ObservedVarIter.h"
 #include "algorithms/planning/MCTSNodeData.h"
 
 using namespace hopi::nodes;
-using namespace hopi::iterators;
 using namespace hopi::distributions;
 using namespace hopi::math;
 using namespace hopi::api;
@@ -23,7 +25,7 @@ using namespace torch::detail;
 
 namespace hopi::graphs {
 
-    static std::shared_ptr<FactorGraph> currentFactorGraph = nullptr;
+    static thread_local std::shared_ptr<FactorGraph> currentFactorGraph = nullptr;
 
     std::shared_ptr<FactorGraph> FactorGraph::current() {
         if (currentFactorGraph == nullptr)
@@ -39,16 +41,220 @@ namespace hopi::graphs {
         currentFactorGraph = ptr;
     }
 
-    FactorGraph::FactorGraph() : _tree_root(nullptr) {}
+    FactorGraph::FactorGraph() : _tree_root(nullptr), _batch_size(0), _window_size(0), _memory_tracking(false), _peak_memory(0),
+        _structure_version(0) {}
+
+    std::unique_ptr<FactorNode> FactorGraph::createFactor(
+            const FactorNodeType &type,
+            VarNode *child,
+            const std::vector<VarNode*> &parents
+    ) {
+        auto parent = [&parents](int i) { return (i < parents.size()) ? parents[i] : nullptr; };
+
+        switch (type) {
+            case FactorNodeType::CATEGORICAL_NODE:
+                return (parent(0) == nullptr) ?
+                    CategoricalNode::create(child) : CategoricalNode::create(child, parent(0));
+            case FactorNodeType::TRANSITION_NODE:
+                return (parent(1) == nullptr) ?
+                    TransitionNode::create(parent(0), child) : TransitionNode::create(parent(0), child, parent(1));
+            case FactorNodeType::ACTIVE_TRANSITION_NODE:
+                return (parent(2) == nullptr) ?
+                    ActiveTransitionNode::create(parent(0), parent(1), child) :
+                    ActiveTransitionNode::create(parent(0), parent(1), child, parent(2));
+            case FactorNodeType::DIRICHLET_NODE:
+                return DirichletNode::create(child);
+            default:
+                throw std::runtime_error("In FactorGraph::createFactor, unsupported factor type.");
+        }
+    }
+
+    std::shared_ptr<FactorGraph> FactorGraph::fork() {
+        auto fg = std::make_shared<FactorGraph>();
+        fg->_batch_size = _batch_size;
+        fg->_window_size = _window_size;
+        std::unordered_map<const VarNode*, VarNode*> vars;
+        std::unordered_map<const FactorNode*, FactorNode*> factors;
+        auto fork = [](Distribution *d) { return (d == nullptr) ? nullptr : d->fork(); };
+
+        // Collect the variables to clone, i.e., the tree's root and its descendants, or all the variables if the graph
+        // has no tree root
+        std::vector<VarNode*> live;
+        std::unordered_set<const VarNode*> visited;
+        if (_tree_root == nullptr) {
+            live = _vars.values();
+        } else {
+            live.push_back(_tree_root);
+            visited.insert(_tree_root);
+        }
+        for (size_t i = 0; _tree_root != nullptr && i < live.size(); ++i) {
+            for (auto it = live[i]->firstChild(); it != live[i]->lastChild(); ++it) {
+                if (*it != nullptr && visited.insert((*it)->child()).second) {
+                    live.push_back((*it)->child());
+                }
+            }
+        }
+
+        // Clone the variables, sharing the storage of their distributions
+        for (auto var : live) {
+            VarNode *copy = fg->addNode(VarNode::create(var->type()));
+            copy->setName(var->name());
+            copy->setPrior(fork(var->prior()));
+            copy->setPosterior(fork(var->posterior()));
+            copy->setBiased(fork(var->biased()));
+            if (var->hasData()) {
+                *copy->data() = *var->data();
+            }
+            vars[var] = copy;
+        }
+
+        // The other variables read by the cloned factors (e.g., the last state and action of the history) are frozen:
+        // their posterior becomes the prior of a clone that does not belong to the graph, and is therefore never
+        // updated by the algorithms running on the fork
+        auto map = [&fg, &vars, &fork](VarNode *var) -> VarNode* {
+            if (var == nullptr) {
+                return nullptr;
+            }
+            auto it = vars.find(var);
+            if (it != vars.end()) {
+                return it->second;
+            }
+            auto copy = VarNode::create(var->type());
+            copy->setPrior(fork(var->posterior()));
+            copy->setPosterior(fork(var->posterior()));
+            auto type = (var->posterior()->type() == DistributionType::DIRICHLET) ?
+                FactorNodeType::DIRICHLET_NODE : FactorNodeType::CATEGORICAL_NODE;
+            fg->_frozen_factors.push_back(createFactor(type, copy.get(), {}));
+            copy->setParent(fg->_frozen_factors.back().get());
+            fg->_frozen_vars.push_back(std::move(copy));
+            return vars[var] = fg->_frozen_vars.back().get();
+        };
+
+        // Clone the parent factors of the cloned variables
+        for (auto var : live) {
+            FactorNode *factor = var->parent();
+            if (factor == nullptr) {
+                continue;
+            }
+            std::vector<VarNode*> parents;
+            for (int i = 0; i < 3; ++i) {
+                parents.push_back(map(factor->parent(i)));
+            }
+            factors[factor] = fg->addFactor(createFactor(factor->type(), vars[var], parents));
+        }
+
+        // Connect the cloned variables to their factors, keeping the order of the children
+        for (auto var : live) {
+            VarNode *copy = vars[var];
+            if (var->parent() != nullptr) {
+                copy->setParent(factors[var->parent()]);
+            }
+            for (auto it = var->firstChild(); it != var->lastChild(); ++it) {
+                if (*it != nullptr) {
+                    copy->addChild(factors.at(*it));
+                }
+            }
+        }
+
+        // Copy the tree's root and the dirty nodes
+        fg->_tree_root = (_tree_root == nullptr) ? nullptr : vars[_tree_root];
+        fg->clearDirty();
+        for (auto var : dirtyNodes()) {
+            if (visited.count(var) != 0 || _tree_root == nullptr) {
+                fg->markDirty(vars[var]);
+            }
+        }
+        return fg;
+    }
+
+    void FactorGraph::setBatchSize(long size) {
+        _batch_size = size;
+    }
+
+    long FactorGraph::batchSize() const {
+        return _batch_size;
+    }
+
+    void FactorGraph::setWindowSize(int size) {
+        assert(size >= 0 && "FactorGraph::setWindowSize, the window size must be positive.");
+        _window_size = size;
+    }
+
+    int FactorGraph::windowSize() const {
+        return _window_size;
+    }
+
+    void FactorGraph::setMemoryTracking(bool enable) {
+        _memory_tracking = enable;
+        _peak_memory = 0;
+        trackMemory();
+    }
+
+    memory::MemoryReport FactorGraph::memory() const {
+        memory::MemoryReport report;
+        report.addBytes(memory::NODE_OBJECTS, sizeof(FactorGraph));
+        report.addBytes(memory::NODE_OBJECTS, (_hidden.capacity() + _observed.capacity()) * sizeof(VarNode*));
+        for (auto var : _vars.values()) {
+            var->reportMemory(report);
+        }
+        for (auto factor : _factors.values()) {
+            factor->reportMemory(report);
+        }
+        for (auto &var : _frozen_vars) {
+            var->reportMemory(report);
+        }
+        for (auto &factor : _frozen_factors) {
+            factor->reportMemory(report);
+        }
+        report.setPeak(_peak_memory);
+        return report;
+    }
+
+    void FactorGraph::trackMemory() {
+        if (_memory_tracking) {
+            _peak_memory = std::max(_peak_memory, memory().total());
+        }
+    }
 
     VarNode *FactorGraph::addNode(std::unique_ptr<VarNode> node) {
-        _vars.push_back(std::move(node));
-        return _vars[_vars.size() - 1].get();
+        VarNode *ptr = node.get();
+        _vars.insert(std::move(node));
+        ptr->setGraph(this);
+        indexNode(ptr);
+        ++_structure_version;
+        markDirty(ptr);
+        return ptr;
+    }
+
+    void FactorGraph::markDirty(VarNode *node) {
+        if (_dirty_set.insert(node).second) {
+            _dirty.push_back(node);
+        }
+    }
+
+    long FactorGraph::structureVersion() const {
+        return _structure_version;
+    }
+
+    std::vector<VarNode*> FactorGraph::dirtyNodes() {
+        // Drop the entries of the nodes removed since they were marked, keeping the order in which nodes were marked
+        std::unordered_set<VarNode*> seen;
+        _dirty.erase(std::remove_if(_dirty.begin(), _dirty.end(), [this, &seen](VarNode *node) {
+            return _dirty_set.count(node) == 0 || !seen.insert(node).second;
+        }), _dirty.end());
+        return _dirty;
+    }
+
+    void FactorGraph::clearDirty() {
+        _dirty.clear();
+        _dirty_set.clear();
     }
 
     FactorNode *FactorGraph::addFactor(std::unique_ptr<FactorNode> factor) {
-        _factors.push_back(std::move(factor));
-        return _factors[_factors.size() - 1].get();
+        FactorNode *ptr = factor.get();
+        _factors.insert(std::move(factor));
+        ++_structure_version;
+        return ptr;
     }
 
     void FactorGraph::setTreeRoot(VarNode *root) {
@@ -60,31 +266,101 @@ namespace hopi::graphs {
     }
 
     int FactorGraph::nHiddenVar() const {
-        return (int) std::count_if(_vars.begin(), _vars.end(), [](const std::unique_ptr<VarNode> & elem) {
-            return (elem->type() == VarNodeType::HIDDEN);
-        });
+        return (int) _hidden.size();
     }
 
     int FactorGraph::nObservedVar() const {
-        return (int) std::count_if(_vars.begin(), _vars.end(), [](const std::unique_ptr<VarNode> & elem) {
-            return (elem->type() == VarNodeType::OBSERVED);
-        });
+        return (int) _observed.size();
+    }
+
+    const std::vector<VarNode*> &FactorGraph::hiddenNodes() const {
+        return _hidden;
+    }
+
+    const std::vector<VarNode*> &FactorGraph::observedNodes() const {
+        return _observed;
+    }
+
+    std::vector<VarNode*> FactorGraph::nodesByName(const std::string &name) const {
+        std::vector<VarNode*> res;
+        auto range = _names.equal_range(name);
+        for (auto it = range.first; it != range.second; ++it) {
+            res.push_back(it->second);
+        }
+        return res;
+    }
+
+    std::vector<VarNode*> &FactorGraph::typeIndex(VarNodeType type) {
+        return (type == VarNodeType::HIDDEN) ? _hidden : _observed;
+    }
+
+    void FactorGraph::indexNode(VarNode *node) {
+        auto &index = typeIndex(node->type());
+        _type_positions[node] = (int) index.size();
+        index.push_back(node);
+        if (!node->name().empty()) {
+            _names.emplace(node->name(), node);
+        }
+    }
+
+    void FactorGraph::unindexNode(VarNode *node, VarNodeType type, const std::string &name) {
+        // Swap the node with the last element of its type index, then pop it
+        auto &index = typeIndex(type);
+        auto it = _type_positions.find(node);
+        assert(it != _type_positions.end() && "FactorGraph::unindexNode, the node is not indexed.");
+        int position = it->second;
+        index[position] = index.back();
+        _type_positions[index[position]] = position;
+        index.pop_back();
+        _type_positions.erase(node);
+
+        if (!name.empty()) {
+            auto range = _names.equal_range(name);
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                if (entry->second == node) {
+                    _names.erase(entry);
+                    break;
+                }
+            }
+        }
+    }
+
+    void FactorGraph::onTypeChanged(VarNode *node, VarNodeType old_type) {
+        unindexNode(node, old_type, node->name());
+        indexNode(node);
+        if (node->type() != old_type) {
+            // The set of hidden variables is part of the structure, e.g., it is captured by the inference plans
+            ++_structure_version;
+        }
+    }
+
+    void FactorGraph::onNameChanged(VarNode *node, const std::string &old_name) {
+        unindexNode(node, node->type(), old_name);
+        indexNode(node);
     }
 
     VarNode *FactorGraph::node(int i) {
-        return _vars[i].get();
+        return _vars[i];
+    }
+
+    SlotHandle FactorGraph::handle(const VarNode *node) const {
+        return _vars.handle(node);
+    }
+
+    VarNode *FactorGraph::node(const SlotHandle &handle) const {
+        return _vars.get(handle);
     }
 
     int FactorGraph::nodes() const {
-        return (int) _vars.size();
+        return _vars.size();
     }
 
     int FactorGraph::factors() const {
-        return (int) _factors.size();
+        return _factors.size();
     }
 
     nodes::FactorNode *FactorGraph::factor(int i) {
-        return _factors[i].get();
+        return _factors[i];
     }
 
     void FactorGraph::loadEvidence(int nobs, const std::string& file_name) {
@@ -100,12 +376,10 @@ namespace hopi::graphs {
             }
             name = line.substr(0, i);
             obs = std::stoi(line.substr(i + 1));
-            ObservedVarIter it(this);
-            while (*it != nullptr) {
-                if ((*it)->name() == name) {
-                    (*it)->setPosterior(Categorical::create(Ops::one_hot(nobs, obs)));
+            for (auto node : nodesByName(name)) {
+                if (node->type() == VarNodeType::OBSERVED) {
+                    node->setPosterior(Categorical::create(Ops::one_hot(nobs, obs)));
                 }
-                ++it;
             }
         }
     }
@@ -125,7 +399,7 @@ namespace hopi::graphs {
     void FactorGraph::removeHiddenStatesChildren(VarNode *node) {
         for (auto it = node->firstChild(); it != node->lastChild() ; ++it) {
             auto child = (*it)->child();
-            if (child->data()->action == -1) {
+            if (child->action() == -1) {
                 continue;
             } else {
                 removeBranch(*it);
@@ -158,10 +432,10 @@ namespace hopi::graphs {
             VarNode *A,
             VarNode *B
     ) {
-        assert(B->prior()->params().dim() == 3 && "FactorGraph::integrate, B must be 3-random-tensor.");
+        assert(B->prior()->paramsView().dim() == 3 && "FactorGraph::integrate, B must be 3-random-tensor.");
 
         // Create a categorical distribution over action
-        auto B_param = B->prior()->params();
+        auto B_param = B->prior()->paramsView();
         long actions = B_param.size(B_param.dim() - 1);
         Tensor action_param = API::full({actions}, 0.1 / ((double) actions - 1));
         action_param[action] = 0.9;
@@ -189,6 +463,27 @@ namespace hopi::graphs {
         integrate(a, observation, A, B);
     }
 
+    void FactorGraph::integrate(
+            const std::vector<int> &actions,
+            const Tensor &observations,
+            const Tensor &A,
+            const Tensor &B
+    ) {
+        assert(B.dim() == 3 && "FactorGraph::integrate, B must be 3-tensor.");
+        assert(_batch_size == (long) actions.size() && "FactorGraph::integrate, one action per agent is required.");
+
+        // Create a categorical distribution over action for each agent
+        auto n_actions = B.size(2);
+        Tensor action_param = API::full({_batch_size, n_actions}, 0.1 / ((double) n_actions - 1));
+        for (int i = 0; i < _batch_size; ++i) {
+            action_param[i][actions[i]] = 0.9;
+        }
+        auto a = API::Categorical(action_param);
+
+        // Call generic integrate function
+        integrate(a, observations, A, B);
+    }
+
     void FactorGraph::integrate(
             VarNode *U,
             int action,
@@ -197,7 +492,7 @@ namespace hopi::graphs {
             VarNode *B
     ) {
         assert(U->prior()->type() == DIRICHLET && "FactorGraph::integrate, U must be distributed according to a Dirichlet.");
-        assert(B->prior()->params().dim() == 3 && "FactorGraph::integrate, B must be 3-random-tensor.");
+        assert(B->prior()->paramsView().dim() == 3 && "FactorGraph::integrate, B must be 3-random-tensor.");
 
         // Increase Dirichlet parameters
         auto p = U->prior()->params();
@@ -218,8 +513,12 @@ namespace hopi::graphs {
             const Tensor& observation,
             T1 A, T2 B
     ) {
-        // Cut-off child branches
+        // The tree expanded during planning is at its largest just before being cut-off
+        trackMemory();
+
+        // Cut-off child branches, and mark the previous root as dirty since it is connected to the new slice
         removeHiddenChildren(_tree_root);
+        markDirty(_tree_root);
 
         // Create new slide of action/state/observation.
         auto *new_root = API::ActiveTransition(_tree_root, a, B);
@@ -229,55 +528,155 @@ namespace hopi::graphs {
 
         // Clean up the factor graph
         setTreeRoot(new_root);
+        if (_window_size > 0) {
+            absorbOldSlices();
+        }
+        trackMemory();
     }
 
-    void FactorGraph::removeBranch(FactorNode *node) {
-        node->parent(0)->disconnectChild(node);
-        auto itf = std::find_if(_factors.begin(), _factors.end(), [node](const std::unique_ptr<FactorNode>& n) {
-            return n.get() == node;
-        });
-        auto itv = std::find_if(_vars.begin(), _vars.end(), [node](const std::unique_ptr<VarNode>& n) {
-            return n.get() == node->child();
-        });
+    /**
+     * Getter.
+     * @param factor the factor whose parameters must be returned
+     * @param index the index of the parent representing the factor's parameters
+     * @return the parameters of the factor if they are fixed, or their expectation if they are distributed according
+     * to a Dirichlet
+     */
+    static Tensor expectedParams(FactorNode *factor, int index) {
+        VarNode *param = factor->parent(index);
+        if (param == nullptr) {
+            return factor->child()->prior()->paramsView();
+        }
+        return Dirichlet::expectation(param->posterior()->paramsView());
+    }
 
-        for (auto i = (*itv)->firstChild(); i != (*itv)->lastChild(); ++i) {
-            removeBranch(*i);
+    void FactorGraph::absorbOldSlices() {
+        // Walk back along the chain of states, from the root to the oldest state
+        std::vector<VarNode*> states{_tree_root};
+        while (states.back()->parent()->type() == FactorNodeType::ACTIVE_TRANSITION_NODE) {
+            states.push_back(states.back()->parent()->parent(0));
+        }
+        if (states.back()->parent()->type() != FactorNodeType::CATEGORICAL_NODE) {
+            throw std::runtime_error("In FactorGraph::absorbOldSlices, unsupported graph structure.");
+        }
+        for (int i = (int) states.size() - 1; i >= _window_size; --i) {
+            absorbSlice(states[i]);
         }
-        itf->reset();
-        itv->reset();
-        removeNullNodes();
-        removeNullFactors();
     }
 
-    void FactorGraph::removeNullNodes() {
-        _vars.erase(std::remove_if(_vars.begin(), _vars.end(),
-                                   [](std::unique_ptr<VarNode> &x){return x == nullptr;}), _vars.end());
+    void FactorGraph::absorbSlice(VarNode *state) {
+        // Collect the factors of the slice, i.e., the prior over the state, the likelihoods of the observations, and
+        // the transition to the next state
+        std::vector<FactorNode*> factors{state->parent()};
+        std::vector<VarNode*> vars{state};
+        FactorNode *transition = nullptr;
+        for (auto it = state->firstChild(); it != state->lastChild(); ++it) {
+            if (*it == nullptr) {
+                continue;
+            }
+            if ((*it)->type() == FactorNodeType::ACTIVE_TRANSITION_NODE) {
+                transition = *it;
+            } else if ((*it)->type() == FactorNodeType::TRANSITION_NODE &&
+                       (*it)->child()->type() == VarNodeType::OBSERVED) {
+                factors.push_back(*it);
+                vars.push_back((*it)->child());
+            } else {
+                throw std::runtime_error("In FactorGraph::absorbSlice, unsupported graph structure.");
+            }
+        }
+        assert(transition != nullptr && "FactorGraph::absorbSlice, the slice must be followed by another slice.");
+        VarNode *action = transition->parent(1);
+        VarNode *next = transition->child();
+        factors.push_back(action->parent());
+        factors.push_back(transition);
+        vars.push_back(action);
+
+        // Compute the message sent by the slice to the next state, i.e., sum over the state and the action of
+        // P(next|state,action) P(state) P(action) \prod_i P(o_i|state)
+        Tensor belief = expectedParams(state->parent(), 0);
+        for (int i = 1; i < (int) factors.size() - 2; ++i) {
+            belief = belief * matmul(factors[i]->child()->posterior()->paramsView(), expectedParams(factors[i], 1));
+        }
+        Tensor actions = expectedParams(action->parent(), 0);
+        Tensor prior;
+        if (_batch_size > 0) {
+            if (belief.dim() == 1) belief = belief.unsqueeze(0).expand({_batch_size, belief.size(0)});
+            if (actions.dim() == 1) actions = actions.unsqueeze(0).expand({_batch_size, actions.size(0)});
+            prior = einsum("ksa,bs,ba->bk", {expectedParams(transition, 2), belief, actions});
+        } else {
+            prior = einsum("ksa,s,a->k", {expectedParams(transition, 2), belief, actions});
+        }
+        prior = prior / prior.sum(prior.dim() - 1, true);
+
+        // Keep what the slice taught to the Dirichlet parameters, by adding its messages to their priors
+        std::unordered_set<VarNode*> parents;
+        for (auto factor : factors) {
+            for (int i = 0; i < 3; ++i) {
+                VarNode *param = factor->parent(i);
+                if (param == nullptr || std::find(vars.begin(), vars.end(), param) != vars.end()) {
+                    continue;
+                }
+                if (param->prior() != nullptr && param->prior()->type() == DIRICHLET) {
+                    param->prior()->updateParams(param->prior()->paramsView() + factor->message(param));
+                }
+                param->disconnectChild(factor);
+                parents.insert(param);
+            }
+        }
+        for (auto param : parents) {
+            param->removeNullChildren();
+            markDirty(param);
+        }
+
+        // Replace the transition to the next state by a categorical prior
+        next->setPrior(Categorical::create(prior));
+        next->setParent(addFactor(CategoricalNode::create(next)));
+        markDirty(next);
+
+        // Delete the nodes of the slice
+        for (auto factor : factors) {
+            _factors.erase(factor);
+        }
+        for (auto var : vars) {
+            eraseNode(var);
+        }
+        ++_structure_version;
     }
 
-    void FactorGraph::removeNullFactors() {
-        _factors.erase(std::remove_if(_factors.begin(), _factors.end(),
-                                      [](std::unique_ptr<FactorNode> &x){return x == nullptr;}), _factors.end());
+    void FactorGraph::eraseNode(VarNode *node) {
+        _dirty_set.erase(node);
+        unindexNode(node, node->type(), node->name());
+        _vars.erase(node);
     }
 
-    std::vector<VarNode*> FactorGraph::getNodes() {
-        std::vector<VarNode*> vars;
+    void FactorGraph::removeBranch(FactorNode *node) {
+        node->parent(0)->disconnectChild(node);
+        VarNode *child = node->child();
 
-        for (auto & _var : _vars) {
-            vars.push_back(_var.get());
+        for (auto i = child->firstChild(); i != child->lastChild(); ++i) {
+            if (*i != nullptr) {
+                removeBranch(*i);
+            }
         }
-        return vars;
+        _factors.erase(node);
+        eraseNode(child);
+        ++_structure_version;
+    }
+
+    std::vector<VarNode*> FactorGraph::getNodes() {
+        return _vars.values();
     }
 
     void FactorGraph::writeGraphviz(const std::string &file_name, const std::vector<VarNodeAttr> &display, bool display_posterior) {
-        static std::pair<std::string, int> dvn("n", 0);
-        static std::pair<std::string, int> dfn("f", 0);
+        static thread_local std::pair<std::string, int> dvn("n", 0);
+        static thread_local std::pair<std::string, int> dfn("f", 0);
         GraphViz viz(file_name);
 
-        viz.writeNodes(dvn, dfn, _vars);
-        viz.writeFactors(dvn, dfn, _factors);
-        viz.writeData(dvn, _vars, display);
+        auto vars = _vars.values();
+        viz.writeNodes(dvn, dfn, vars);
+        viz.writeFactors(dvn, dfn, _factors.values());
+        viz.writeData(dvn, vars, display);
         if (display_posterior)
-            viz.writePosteriors(dvn, _vars);
+            viz.writePosteriors(dvn, vars);
     }
 
 }
\ No newline at end of file
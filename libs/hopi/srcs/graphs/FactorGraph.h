@@ -7,9 +7,15 @@
 
 #include <memory>
 #include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <string>
 #include <torch/torch.h>
 #include "nodes/VarNodeType.h"
 #include "nodes/VarNodeAttr.h"
+#include "nodes/FactorNodeType.h"
+#include "graphs/SlotMap.h"
+#include "memory/MemoryReport.h"
 
 namespace hopi::nodes {
     class VarNode;
@@ -24,14 +30,15 @@ namespace hopi::graphs {
     class FactorGraph {
     public:
         //
-        // The current factor graph on which the user works is stored as a static variable. The following functions
-        // allows the user to access this factor graph and to change the factor graph on which he (i.e., the user)
-        // is working.
+        // The current factor graph on which the user works is stored as a thread local variable, i.e., each thread
+        // has its own current graph and can build and run its own model. The following functions allows the user to
+        // access this factor graph and to change the factor graph on which he (i.e., the user) is working. See also
+        // GraphContext, which changes the current graph within a scope.
         //
 
         /**
          * Getter.
-         * @return the current factor graph
+         * @return the current factor graph of the calling thread
          */
         static std::shared_ptr<FactorGraph> current();
 
@@ -51,15 +58,43 @@ namespace hopi::graphs {
          */
         static void setCurrent(std::shared_ptr<FactorGraph> &&ptr);
 
+        /**
+         * Create a factor node of a given type, the factor is not connected to its neighbours, i.e., the caller is
+         * responsible for adding the factor to the children of its parents and for setting the child's parent.
+         * @param type the type of factor to create
+         * @param child the variable generated by the factor
+         * @param parents the parents of the factor in the order of FactorNode::parent, the optional parameters
+         * (e.g., the Dirichlet over a transition matrix) can be nullptr
+         * @return the created factor
+         */
+        static std::unique_ptr<nodes::FactorNode> createFactor(
+                const nodes::FactorNodeType &type,
+                nodes::VarNode *child,
+                const std::vector<nodes::VarNode*> &parents
+        );
+
     public:
         /**
          * Create a new factor graph without any nodes.
          */
         FactorGraph();
 
+        /**
+         * Create a fork of the graph for planning, i.e., a clone of the tree's root and of its descendants. The history
+         * preceding the tree's root is not copied: the variables that it shares with the cloned factors (e.g., the
+         * previous state and action) are frozen, i.e., replaced by clones whose prior is their current posterior and
+         * that do not belong to the fork, so the cost of the fork does not depend on the length of the history. If
+         * the graph has no tree root, all the variables are cloned. The distributions share their storage with the
+         * original until either graph updates them (copy-on-write). The fork can then be expanded and inferred
+         * independently of the original.
+         * @return the fork
+         */
+        std::shared_ptr<FactorGraph> fork();
+
         /**
          * Cut-off the branches of the tree that was expanded during planning, then add a new slice to the BTAI by
          * assuming that the action "action" has been taken and that the observation "observation" has been made.
+         * The nodes of the new slice as well as the previous root are marked as dirty.
          * @param U the parameter of the prior over actions
          * @param action the action performed
          * @param observation the observation made
@@ -119,6 +154,63 @@ namespace hopi::graphs {
                 nodes::VarNode *B
         );
 
+        /**
+         * Cut-off the branches of the tree that was expanded during planning, then add a new slice to a batched
+         * graph by assuming that each agent took its own action and made its own observation.
+         * @param actions the action performed by each agent
+         * @param observations the observations made by the agents, i.e., a [batch size, observation size] tensor
+         * @param A the likelihood mapping to use when adding the slice
+         * @param B the transition mapping to use when adding the slice
+         */
+        void integrate(
+                const std::vector<int> &actions,
+                const torch::Tensor& observations,
+                const torch::Tensor& A,
+                const torch::Tensor& B
+        );
+
+        /**
+         * Setter.
+         * @param size the number of independent agents sharing the graph's structure, the posterior of each node
+         * created afterwards is a [size, dim] tensor, 0 (the default) means that the graph is not batched
+         */
+        void setBatchSize(long size);
+
+        /**
+         * Getter.
+         * @return the number of independent agents sharing the graph's structure, 0 if the graph is not batched
+         */
+        [[nodiscard]] long batchSize() const;
+
+        /**
+         * Setter.
+         * @param size the maximum number of time slices kept in the graph, when a new slice is integrated in a graph
+         * that already contains "size" slices, the oldest slice is absorbed into a categorical prior over the next
+         * hidden state and its nodes are deleted, 0 (the default) means that the slices are never absorbed
+         */
+        void setWindowSize(int size);
+
+        /**
+         * Getter.
+         * @return the maximum number of time slices kept in the graph, 0 if the slices are never absorbed
+         */
+        [[nodiscard]] int windowSize() const;
+
+        /**
+         * Setter.
+         * @param enable true if the memory used by the graph should be measured every time a slice is integrated,
+         * in order to keep track of the peak memory usage, false (the default) otherwise. Measuring the memory
+         * requires a traversal of the whole graph, so the tracking should only be enabled for profiling.
+         */
+        void setMemoryTracking(bool enable);
+
+        /**
+         * Compute the memory used by the graph, i.e., by its nodes, their distributions and the messages cached by
+         * the factors. Tensors shared by several nodes are only counted once.
+         * @return the memory report, whose peak is the highest total observed since the tracking was enabled
+         */
+        [[nodiscard]] memory::MemoryReport memory() const;
+
         /**
          * Setter.
          * @param root the new root of the tree
@@ -132,12 +224,36 @@ namespace hopi::graphs {
         nodes::VarNode *treeRoot();
 
         /**
-         * Add a new variable node to the graph
+         * Add a new variable node to the graph, the node is marked as dirty.
          * @param node the node to be added
          * @return the added node
          */
         nodes::VarNode *addNode(std::unique_ptr<nodes::VarNode> node);
 
+        /**
+         * Mark a node as dirty, i.e., as a node whose posterior must be re-inferred by the incremental inference.
+         * @param node the node to be marked as dirty
+         */
+        void markDirty(nodes::VarNode *node);
+
+        /**
+         * Getter.
+         * @return the nodes that have been added or modified since the last call to clearDirty
+         */
+        std::vector<nodes::VarNode*> dirtyNodes();
+
+        /**
+         * Unmark all the dirty nodes, i.e., notify the graph that the posteriors of its nodes are up to date.
+         */
+        void clearDirty();
+
+        /**
+         * Getter.
+         * @return the version of the graph's structure, which changes every time a node or a factor is added or
+         * removed from the graph, and every time the type of a node changes
+         */
+        [[nodiscard]] long structureVersion() const;
+
         /**
          * Getter.
          * @return the list of all nodes
@@ -151,6 +267,20 @@ namespace hopi::graphs {
          */
         nodes::VarNode *node(int i);
 
+        /**
+         * Getter.
+         * @param node the node whose handle should be returned
+         * @return a handle to the node, which remains valid until the node is removed from the graph
+         */
+        [[nodiscard]] SlotHandle handle(const nodes::VarNode *node) const;
+
+        /**
+         * Getter.
+         * @param handle the handle of the node that needs to be accessed
+         * @return the node, or nullptr if the node has been removed from the graph
+         */
+        [[nodiscard]] nodes::VarNode *node(const SlotHandle &handle) const;
+
         /**
          * Add a factor to the graph.
          * @param factor the factor be added
@@ -165,6 +295,41 @@ namespace hopi::graphs {
          */
         nodes::FactorNode *factor(int i);
 
+        /**
+         * Getter.
+         * @return the hidden variables of the graph, in no particular order
+         */
+        [[nodiscard]] const std::vector<nodes::VarNode*> &hiddenNodes() const;
+
+        /**
+         * Getter.
+         * @return the observed variables of the graph, in no particular order
+         */
+        [[nodiscard]] const std::vector<nodes::VarNode*> &observedNodes() const;
+
+        /**
+         * Getter.
+         * @param name the name of the nodes that must be returned
+         * @return the variables of the graph whose name is equal to "name"
+         */
+        [[nodiscard]] std::vector<nodes::VarNode*> nodesByName(const std::string &name) const;
+
+        /**
+         * Update the indices of the graph after the type of one of its nodes changed, this function is called by
+         * VarNode::setType.
+         * @param node the node whose type changed
+         * @param old_type the previous type of the node
+         */
+        void onTypeChanged(nodes::VarNode *node, nodes::VarNodeType old_type);
+
+        /**
+         * Update the indices of the graph after the name of one of its nodes changed, this function is called by
+         * VarNode::setName.
+         * @param node the node whose name changed
+         * @param old_name the previous name of the node
+         */
+        void onNameChanged(nodes::VarNode *node, const std::string &old_name);
+
         /**
          * Getter.
          * @return the number of hidden variables in the graph
@@ -205,7 +370,8 @@ namespace hopi::graphs {
         void writeGraphviz(const std::string& file_name, const std::vector<nodes::VarNodeAttr> &display, bool display_posterior = false);
 
         /**
-         * Cut-off the branch corresponding to the input node
+         * Cut-off the branch corresponding to the input node. The cost of the removal is proportional to the size
+         * of the branch, i.e., it does not depend on the size of the graph.
          * @param node the node at the top of the branch to be deleted
          */
         void removeBranch(nodes::FactorNode *node);
@@ -224,14 +390,52 @@ namespace hopi::graphs {
 
     private:
         /**
-         * Remove all the nullptr from the list of variable nodes.
+         * Absorb the oldest time slices into a categorical prior over the next hidden state until the graph
+         * contains at most "window size" slices.
+         */
+        void absorbOldSlices();
+
+        /**
+         * Absorb the oldest time slice into a categorical prior over the next hidden state, then delete the nodes of
+         * the slice, i.e., the oldest hidden state, its observations and the action that led to the next state. The
+         * absorption is exact for the chain structure built by integrate, and the messages that the slice was
+         * sending to Dirichlet parameters are added to the prior of these parameters, so that what has been learned
+         * from the slice is kept.
+         * @param state the oldest hidden state
          */
-        void removeNullNodes();
+        void absorbSlice(nodes::VarNode *state);
 
         /**
-         * Remove all the nullptr from the list of factor nodes.
+         * Remove a variable node from the graph and from its indices, then destroy it.
+         * @param node the node to be removed
+         */
+        void eraseNode(nodes::VarNode *node);
+
+        /**
+         * Update the peak memory usage, if the memory tracking is enabled.
+         */
+        void trackMemory();
+
+        /**
+         * Add a node to the index of its type and to the index of its name.
+         * @param node the node to be indexed
+         */
+        void indexNode(nodes::VarNode *node);
+
+        /**
+         * Remove a node from the index of its type and from the index of its name.
+         * @param node the node to be removed from the indices
+         * @param type the type under which the node is indexed
+         * @param name the name under which the node is indexed
+         */
+        void unindexNode(nodes::VarNode *node, nodes::VarNodeType type, const std::string &name);
+
+        /**
+         * Getter.
+         * @param type the type of variables whose index must be returned
+         * @return the list of variables of that type
          */
-        void removeNullFactors();
+        std::vector<nodes::VarNode*> &typeIndex(nodes::VarNodeType type);
 
         /**
          * Cut-off the branches of the tree that was expanded during planning, then add a new slice to the BTAI by
@@ -251,9 +455,22 @@ namespace hopi::graphs {
         );
 
     private:
-        std::vector<std::unique_ptr<hopi::nodes::VarNode>> _vars;
-        std::vector<std::unique_ptr<hopi::nodes::FactorNode>> _factors;
+        SlotMap<nodes::VarNode> _vars;
+        SlotMap<nodes::FactorNode> _factors;
         nodes::VarNode *_tree_root;
+        long _batch_size;
+        int _window_size;
+        bool _memory_tracking;
+        std::size_t _peak_memory;
+        long _structure_version;
+        std::vector<nodes::VarNode*> _dirty;
+        std::unordered_set<nodes::VarNode*> _dirty_set;
+        std::vector<nodes::VarNode*> _hidden;
+        std::vector<nodes::VarNode*> _observed;
+        std::unordered_map<const nodes::VarNode*, int> _type_positions;
+        std::unordered_multimap<std::string, nodes::VarNode*> _names;
+        std::vector<std::unique_ptr<nodes::VarNode>> _frozen_vars;
+        std::vector<std::unique_ptr<nodes::FactorNode>> _frozen_factors;
     };
 
 }
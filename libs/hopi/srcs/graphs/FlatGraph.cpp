@@ -0,0 +1,209 @@
+#include "FlatGraph.h"
+#include "FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Distribution.h"
+#include "algorithms/planning/MCTSNodeData.h"
+#include "api/API.h"
+#include <unordered_set>
+
+using namespace hopi::nodes;
+using namespace hopi::distributions;
+using namespace hopi::api;
+using namespace torch;
+
+namespace hopi::graphs {
+
+    std::unique_ptr<FlatGraph> FlatGraph::create(const std::shared_ptr<FactorGraph> &fg) {
+        return std::make_unique<FlatGraph>(fg);
+    }
+
+    FlatGraph::FlatGraph(const std::shared_ptr<FactorGraph> &fg) {
+        std::vector<FactorNode*> factors;
+        for (int i = 0; i < fg->factors(); ++i) {
+            factors.push_back(fg->factor(i));
+        }
+        build(fg->getNodes(), factors);
+    }
+
+    std::unique_ptr<FlatGraph> FlatGraph::create(const std::vector<VarNode*> &vars) {
+        return std::make_unique<FlatGraph>(vars);
+    }
+
+    FlatGraph::FlatGraph(const std::vector<VarNode*> &vars) {
+        // Collect the factors adjacent to the variables, in the order in which they are encountered
+        std::vector<FactorNode*> factors;
+        std::unordered_set<FactorNode*> visited;
+        auto visit = [&factors, &visited](FactorNode *factor) {
+            if (factor != nullptr && visited.insert(factor).second) {
+                factors.push_back(factor);
+            }
+        };
+        for (auto var : vars) {
+            visit(var->parent());
+            for (auto it = var->firstChild(); it != var->lastChild(); ++it) {
+                visit(*it);
+            }
+        }
+        build(vars, factors);
+    }
+
+    void FlatGraph::build(const std::vector<VarNode*> &vars, const std::vector<FactorNode*> &factors) {
+        // Assign a handle to each factor
+        std::unordered_map<FactorNode*, int> handles;
+        _factors = factors;
+        for (int i = 0; i < _factors.size(); ++i) {
+            handles.emplace(_factors[i], i);
+        }
+        auto factorHandle = [&handles](FactorNode *factor) {
+            auto it = handles.find(factor);
+            return (it == handles.end()) ? -1 : it->second;
+        };
+
+        // Assign a handle to each variable
+        _vars = vars;
+        for (int i = 0; i < _vars.size(); ++i) {
+            _handles.emplace(_vars[i], i);
+        }
+
+        // Store the variables' data, the children disconnected by FactorGraph::removeBranch are null and skipped
+        std::vector<long> offsets;
+        long size = 0;
+        for (auto var : _vars) {
+            _var_types.push_back(var->type());
+            _var_parent.push_back(factorHandle(var->parent()));
+            _var_children_offsets.push_back((int) _var_children.size());
+            for (auto it = var->firstChild(); it != var->lastChild(); ++it) {
+                int child = factorHandle(*it);
+                if (child != -1) {
+                    _var_children.push_back(child);
+                }
+            }
+            auto &data = var->dataOrDefault();
+            _actions.push_back(data.action);
+            _visits.push_back(data.visits);
+            _costs.push_back(data.cost);
+            offsets.push_back(size);
+            size += (var->posterior() == nullptr) ? 0 : var->posterior()->paramsView().numel();
+        }
+        _var_children_offsets.push_back((int) _var_children.size());
+        offsets.push_back(size);
+
+        // Store the factors' data
+        for (auto factor : _factors) {
+            _factor_types.push_back(factor->type());
+            _factor_child.push_back(handle(factor->child()));
+            _factor_parents_offsets.push_back((int) _factor_parents.size());
+            for (auto var : factor->neighbours()) {
+                if (var != factor->child()) {
+                    _factor_parents.push_back(handle(var));
+                }
+            }
+        }
+        _factor_parents_offsets.push_back((int) _factor_parents.size());
+
+        // Create the belief buffer
+        _beliefs = API::empty({size});
+        for (int i = 0; i < _vars.size(); ++i) {
+            _views.push_back(_beliefs.narrow(0, offsets[i], offsets[i + 1] - offsets[i]));
+        }
+        load();
+    }
+
+    int FlatGraph::nVars() const {
+        return (int) _vars.size();
+    }
+
+    int FlatGraph::nFactors() const {
+        return (int) _factors.size();
+    }
+
+    int FlatGraph::handle(VarNode *node) const {
+        auto it = _handles.find(node);
+        return (it == _handles.end()) ? -1 : it->second;
+    }
+
+    VarNode *FlatGraph::node(int handle) const {
+        return _vars[handle];
+    }
+
+    FactorNode *FlatGraph::factor(int handle) const {
+        return _factors[handle];
+    }
+
+    VarNodeType FlatGraph::varType(int var) const {
+        return _var_types[var];
+    }
+
+    int FlatGraph::parent(int var) const {
+        return _var_parent[var];
+    }
+
+    std::vector<int>::const_iterator FlatGraph::firstChild(int var) const {
+        return _var_children.begin() + _var_children_offsets[var];
+    }
+
+    std::vector<int>::const_iterator FlatGraph::lastChild(int var) const {
+        return _var_children.begin() + _var_children_offsets[var + 1];
+    }
+
+    FactorNodeType FlatGraph::factorType(int factor) const {
+        return _factor_types[factor];
+    }
+
+    int FlatGraph::child(int factor) const {
+        return _factor_child[factor];
+    }
+
+    std::vector<int>::const_iterator FlatGraph::firstParent(int factor) const {
+        return _factor_parents.begin() + _factor_parents_offsets[factor];
+    }
+
+    std::vector<int>::const_iterator FlatGraph::lastParent(int factor) const {
+        return _factor_parents.begin() + _factor_parents_offsets[factor + 1];
+    }
+
+    int FlatGraph::action(int var) const {
+        return _actions[var];
+    }
+
+    int FlatGraph::visits(int var) const {
+        return _visits[var];
+    }
+
+    double FlatGraph::cost(int var) const {
+        return _costs[var];
+    }
+
+    Tensor FlatGraph::belief(int var) const {
+        return _views[var];
+    }
+
+    Tensor FlatGraph::beliefs() const {
+        return _beliefs;
+    }
+
+    void FlatGraph::load() {
+        for (int i = 0; i < _vars.size(); ++i) {
+            if (_views[i].numel() != 0) {
+                _views[i].copy_(_vars[i]->posterior()->paramsView().reshape({-1}));
+            }
+        }
+    }
+
+    void FlatGraph::store() {
+        for (int i = 0; i < _vars.size(); ++i) {
+            auto posterior = _vars[i]->posterior();
+            if (_var_types[i] != HIDDEN || posterior == nullptr || posterior->type() != CATEGORICAL) {
+                continue;
+            }
+            // The posteriors that did not change keep their version, so that the caches depending on them stay valid
+            const Tensor &param = posterior->paramsView();
+            if (!torch::equal(_views[i], param.reshape({-1}))) {
+                // The categorical distributions are updated from their natural parameters, i.e., the log beliefs
+                posterior->updateParams(_views[i].log().reshape(param.sizes()));
+            }
+        }
+    }
+
+}
@@ -0,0 +1,229 @@
+#ifndef HOMING_PIGEON_FLAT_GRAPH_H
+#define HOMING_PIGEON_FLAT_GRAPH_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <torch/torch.h>
+#include "nodes/VarNodeType.h"
+#include "nodes/FactorNodeType.h"
+
+namespace hopi::nodes {
+    class VarNode;
+    class FactorNode;
+}
+
+namespace hopi::graphs {
+
+    class FactorGraph;
+
+    /**
+     * A struct-of-arrays snapshot of a factor graph. The variables and factors are identified by stable integer
+     * handles, i.e., their index in the snapshot, and their types, edges (in compressed adjacency lists), MCTS data
+     * and beliefs are copied into contiguous arrays. The beliefs of all the variables are stored in a single buffer.
+     *
+     * The sweeps of VMP and the inference plans traverse the edges of the snapshot instead of chasing the pointers
+     * of the nodes, while the messages are still computed by the factors. Changes to the graph's structure or MCTS
+     * data made after the snapshot was taken are not reflected, and the beliefs can be synchronised with the graph
+     * using load and store.
+     */
+    class FlatGraph {
+    public:
+        /**
+         * Take a struct-of-arrays snapshot of a factor graph.
+         * @param fg the factor graph
+         * @return the flat graph
+         */
+        static std::unique_ptr<FlatGraph> create(const std::shared_ptr<FactorGraph> &fg);
+
+        /**
+         * Constructor, i.e., take a struct-of-arrays snapshot of a factor graph.
+         * @param fg the factor graph
+         */
+        explicit FlatGraph(const std::shared_ptr<FactorGraph> &fg);
+
+        /**
+         * Take a struct-of-arrays snapshot of some variables and of the factors adjacent to them.
+         * @param vars the variables
+         * @return the flat graph
+         */
+        static std::unique_ptr<FlatGraph> create(const std::vector<nodes::VarNode*> &vars);
+
+        /**
+         * Constructor, i.e., take a struct-of-arrays snapshot of some variables and of the factors adjacent to them.
+         * The factors' neighbours that are not among the variables have the handle -1.
+         * @param vars the variables
+         */
+        explicit FlatGraph(const std::vector<nodes::VarNode*> &vars);
+
+        /**
+         * Getter.
+         * @return the number of variables
+         */
+        [[nodiscard]] int nVars() const;
+
+        /**
+         * Getter.
+         * @return the number of factors
+         */
+        [[nodiscard]] int nFactors() const;
+
+        /**
+         * Getter.
+         * @param node the variable whose handle must be returned
+         * @return the handle of the variable, or -1 if the variable does not belong to the snapshot
+         */
+        [[nodiscard]] int handle(nodes::VarNode *node) const;
+
+        /**
+         * Getter.
+         * @param handle the variable's handle
+         * @return the variable
+         */
+        [[nodiscard]] nodes::VarNode *node(int handle) const;
+
+        /**
+         * Getter.
+         * @param handle the factor's handle
+         * @return the factor
+         */
+        [[nodiscard]] nodes::FactorNode *factor(int handle) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the type of the variable
+         */
+        [[nodiscard]] nodes::VarNodeType varType(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the handle of the variable's parent factor, or -1 if the variable has no parent
+         */
+        [[nodiscard]] int parent(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return an iterator pointing to the handle of the first child factor of the variable
+         */
+        [[nodiscard]] std::vector<int>::const_iterator firstChild(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return an iterator pointing after the handle of the last child factor of the variable
+         */
+        [[nodiscard]] std::vector<int>::const_iterator lastChild(int var) const;
+
+        /**
+         * Getter.
+         * @param factor the factor's handle
+         * @return the type of the factor
+         */
+        [[nodiscard]] nodes::FactorNodeType factorType(int factor) const;
+
+        /**
+         * Getter.
+         * @param factor the factor's handle
+         * @return the handle of the factor's child, or -1 if the child does not belong to the snapshot
+         */
+        [[nodiscard]] int child(int factor) const;
+
+        /**
+         * Getter.
+         * @param factor the factor's handle
+         * @return an iterator pointing to the handle of the first (non-null) parent of the factor, the parents that
+         * do not belong to the snapshot have the handle -1
+         */
+        [[nodiscard]] std::vector<int>::const_iterator firstParent(int factor) const;
+
+        /**
+         * Getter.
+         * @param factor the factor's handle
+         * @return an iterator pointing after the handle of the last (non-null) parent of the factor
+         */
+        [[nodiscard]] std::vector<int>::const_iterator lastParent(int factor) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the action that led to the variable (MCTS data)
+         */
+        [[nodiscard]] int action(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the number of visits of the variable (MCTS data)
+         */
+        [[nodiscard]] int visits(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the cost of the variable (MCTS data)
+         */
+        [[nodiscard]] double cost(int var) const;
+
+        /**
+         * Getter.
+         * @param var the variable's handle
+         * @return the beliefs of the variable, i.e., a view of the belief buffer
+         */
+        [[nodiscard]] torch::Tensor belief(int var) const;
+
+        /**
+         * Getter.
+         * @return the buffer containing the beliefs of all variables
+         */
+        [[nodiscard]] torch::Tensor beliefs() const;
+
+        /**
+         * Copy the posteriors of the variables into the belief buffer.
+         */
+        void load();
+
+        /**
+         * Write the beliefs of the hidden variables back into their (categorical) posteriors. The posteriors are
+         * updated through Distribution::updateParams, i.e., no distribution is created, and the posteriors whose
+         * beliefs did not change are left untouched.
+         */
+        void store();
+
+    private:
+        /**
+         * Fill the arrays of the snapshot.
+         * @param vars the variables of the snapshot
+         * @param factors the factors of the snapshot
+         */
+        void build(const std::vector<nodes::VarNode*> &vars, const std::vector<nodes::FactorNode*> &factors);
+
+    private:
+        // Variables
+        std::vector<nodes::VarNode*> _vars;
+        std::unordered_map<nodes::VarNode*, int> _handles;
+        std::vector<nodes::VarNodeType> _var_types;
+        std::vector<int> _var_parent;
+        std::vector<int> _var_children_offsets;
+        std::vector<int> _var_children;
+        std::vector<int> _actions;
+        std::vector<int> _visits;
+        std::vector<double> _costs;
+
+        // Factors
+        std::vector<nodes::FactorNode*> _factors;
+        std::vector<nodes::FactorNodeType> _factor_types;
+        std::vector<int> _factor_child;
+        std::vector<int> _factor_parents_offsets;
+        std::vector<int> _factor_parents;
+
+        // Beliefs
+        torch::Tensor _beliefs;
+        std::vector<torch::Tensor> _views;
+    };
+
+}
+
+#endif //HOMING_PIGEON_FLAT_GRAPH_H
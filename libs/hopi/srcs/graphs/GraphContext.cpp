@@ -0,0 +1,15 @@
+#include "GraphContext.h"
+#include "FactorGraph.h"
+
+namespace hopi::graphs {
+
+    GraphContext::GraphContext(const std::shared_ptr<FactorGraph> &fg) {
+        _previous = FactorGraph::current();
+        FactorGraph::setCurrent(std::shared_ptr<FactorGraph>(fg));
+    }
+
+    GraphContext::~GraphContext() {
+        FactorGraph::setCurrent(_previous);
+    }
+
+}
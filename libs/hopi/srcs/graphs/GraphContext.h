@@ -0,0 +1,37 @@
+#ifndef HOMING_PIGEON_GRAPH_CONTEXT_H
+#define HOMING_PIGEON_GRAPH_CONTEXT_H
+
+#include <memory>
+
+namespace hopi::graphs {
+
+    class FactorGraph;
+
+    /**
+     * A class making a factor graph the current graph of the calling thread for the lifetime of the object, i.e.,
+     * the graph in which the functions of the API create new nodes. The previous current graph of the thread is
+     * restored when the object is destroyed, which allows several agents to share a thread.
+     */
+    class GraphContext {
+    public:
+        /**
+         * Constructor, make the factor graph the current graph of the calling thread.
+         * @param fg the factor graph to be used
+         */
+        explicit GraphContext(const std::shared_ptr<FactorGraph> &fg);
+
+        /**
+         * Destructor, restore the previous current graph of the calling thread.
+         */
+        ~GraphContext();
+
+        GraphContext(const GraphContext &) = delete;
+        GraphContext &operator=(const GraphContext &) = delete;
+
+    private:
+        std::shared_ptr<FactorGraph> _previous;
+    };
+
+}
+
+#endif //HOMING_PIGEON_GRAPH_CONTEXT_H
@@ -27,7 +27,7 @@ namespace hopi::graphs {
     void GraphViz::writeNodes(
             std::pair<std::string, int> &dvn,
             std::pair<std::string, int> &dfn,
-            const std::vector<std::unique_ptr<VarNode>> &vars
+            const std::vector<VarNode*> &vars
     ) {
         for (auto & _var : vars) {
             // Get/set nodes' names
@@ -47,7 +47,7 @@ namespace hopi::graphs {
     void GraphViz::writeFactors(
             std::pair<std::string, int> &dvn,
             std::pair<std::string, int> &dfn,
-            const std::vector<std::unique_ptr<FactorNode>> &factors
+            const std::vector<FactorNode*> &factors
     ) {
         for (auto & _factor : factors) {
             // Get/set nodes' names
@@ -67,17 +67,17 @@ namespace hopi::graphs {
 
     void GraphViz::writeData(
             std::pair<std::string, int> &dvn,
-            const std::vector<std::unique_ptr<VarNode>> &vars,
+            const std::vector<VarNode*> &vars,
             const std::vector<VarNodeAttr> &display
     ) {
         std::vector<std::string (*)(VarNode*)> func{
-                [](VarNode *var){ return std::to_string(var->data()->visits); },
-                [](VarNode *var){ return (var->data()->cost == std::numeric_limits<double>::min()) ? "-Infinity" : std::to_string(var->data()->cost); },
-                [](VarNode *var){ return std::to_string(var->data()->action); },
-                [](VarNode *var){ return std::to_string(var->data()->pruned); },
-                [](VarNode *var){ return std::to_string(argmax(var->posterior()->params()).item<int>()); },
-                [](VarNode *var){ return std::to_string(var->data()->cost / var->data()->visits); },
-                [](VarNode *var){ return var->parent()->parent(0) != nullptr ? std::to_string(std::sqrt(std::log(var->parent()->parent(0)->data()->visits) / var->data()->visits)) : "NA"; }
+                [](VarNode *var){ return std::to_string(var->dataOrDefault().visits); },
+                [](VarNode *var){ return (var->dataOrDefault().cost == std::numeric_limits<double>::min()) ? "-Infinity" : std::to_string(var->dataOrDefault().cost); },
+                [](VarNode *var){ return std::to_string(var->dataOrDefault().action); },
+                [](VarNode *var){ return std::to_string(var->dataOrDefault().pruned); },
+                [](VarNode *var){ return std::to_string(argmax(var->posterior()->paramsView()).item<int>()); },
+                [](VarNode *var){ return std::to_string(var->dataOrDefault().cost / var->dataOrDefault().visits); },
+                [](VarNode *var){ return var->parent()->parent(0) != nullptr ? std::to_string(std::sqrt(std::log(var->parent()->parent(0)->dataOrDefault().visits) / var->dataOrDefault().visits)) : "NA"; }
         };
 
         if (display.empty())
@@ -90,7 +90,7 @@ namespace hopi::graphs {
             std::string label = R"(<<table border="0" cellborder="1" cellspacing="0" cellpadding="4">)";
             for (auto i : display) {
                 label += "<TR><TD bgcolor=\"YellowGreen\">" + attrNames[i] + "</TD>" + \
-                             "<TD bgcolor=\"YellowGreen\">" + func[i](var.get()) + "</TD></TR>";
+                             "<TD bgcolor=\"YellowGreen\">" + func[i](var) + "</TD></TR>";
             }
             label += "</table>>";
             _file << "\t" << var_name << "_data [shape=none,margin=0,label=" << label << "]\n";
@@ -99,13 +99,13 @@ namespace hopi::graphs {
 
     void GraphViz::writePosteriors(
             std::pair<std::string,int> &dvn,
-            const std::vector<std::unique_ptr<nodes::VarNode>> &vars
+            const std::vector<nodes::VarNode*> &vars
     ) {
         for (int i = 0; i < vars.size(); ++i) {
             // Create the file describing the posterior distribution
             if (vars[i]->posterior()->type() != distributions::CATEGORICAL)
                 continue;
-            auto param = vars[i]->posterior()->params();
+            auto param = vars[i]->posterior()->paramsView();
             std::string file_distrib_name = _file_name + ".distrib";
             std::ofstream file_distrib;
             file_distrib.open(file_distrib_name);
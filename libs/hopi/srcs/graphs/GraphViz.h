@@ -40,7 +40,7 @@ namespace hopi::graphs {
         void writeNodes(
                 std::pair<std::string,int> &dvn,
                 std::pair<std::string,int> &dfn,
-                const std::vector<std::unique_ptr<nodes::VarNode>> &vars
+                const std::vector<nodes::VarNode*> &vars
         );
 
         /**
@@ -52,7 +52,7 @@ namespace hopi::graphs {
         void writeFactors(
                 std::pair<std::string,int> &dvn,
                 std::pair<std::string,int> &dfn,
-                const std::vector<std::unique_ptr<nodes::FactorNode>> &factors
+                const std::vector<nodes::FactorNode*> &factors
         );
 
         /**
@@ -63,7 +63,7 @@ namespace hopi::graphs {
          */
         void writeData(
                 std::pair<std::string,int> &dvn,
-                const std::vector<std::unique_ptr<nodes::VarNode>> &vars,
+                const std::vector<nodes::VarNode*> &vars,
                 const std::vector<nodes::VarNodeAttr> &display
         );
 
@@ -74,7 +74,7 @@ namespace hopi::graphs {
          */
         void writePosteriors(
                 std::pair<std::string,int> &dvn,
-                const std::vector<std::unique_ptr<nodes::VarNode>> &vars
+                const std::vector<nodes::VarNode*> &vars
         );
 
     private:
@@ -0,0 +1,154 @@
+#ifndef HOMING_PIGEON_SLOT_MAP_H
+#define HOMING_PIGEON_SLOT_MAP_H
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace hopi::graphs {
+
+    /**
+     * A handle to an element of a slot map. The handle remains valid until the element is erased, even if other
+     * elements are added or erased in between. A stale handle is detected by comparing its generation to the
+     * generation of the slot it points to.
+     */
+    struct SlotHandle {
+        int index = -1;
+        unsigned long generation = 0;
+    };
+
+    /**
+     * A container owning its elements, which supports constant time insertion, erasure and lookup. Erased elements
+     * leave a tombstone in their slot, the slot is then recycled through a free list and the insertion order of the
+     * remaining elements is compacted lazily, i.e., only when the elements are accessed by position.
+     * @tparam T the type of the elements
+     */
+    template<class T>
+    class SlotMap {
+    public:
+        /**
+         * Add an element to the map.
+         * @param elem the element to be added
+         * @return a handle to the added element
+         */
+        SlotHandle insert(std::unique_ptr<T> elem) {
+            int index;
+            if (_free.empty()) {
+                index = (int) _slots.size();
+                _slots.push_back(nullptr);
+                _generations.push_back(0);
+            } else {
+                index = _free.back();
+                _free.pop_back();
+            }
+            _indices[elem.get()] = index;
+            _slots[index] = std::move(elem);
+            SlotHandle handle{index, _generations[index]};
+            _order.push_back(handle);
+            return handle;
+        }
+
+        /**
+         * Remove an element from the map, and destroy it.
+         * @param elem the element to be removed
+         */
+        void erase(const T *elem) {
+            auto it = _indices.find(elem);
+            if (it == _indices.end())
+                return;
+            int index = it->second;
+            _indices.erase(it);
+            _slots[index].reset();
+            ++_generations[index];
+            _free.push_back(index);
+            ++_tombstones;
+        }
+
+        /**
+         * Getter.
+         * @param elem the element whose handle should be returned
+         * @return the handle of the element, or an invalid handle if the element is not in the map
+         */
+        SlotHandle handle(const T *elem) const {
+            auto it = _indices.find(elem);
+            if (it == _indices.end())
+                return SlotHandle{};
+            return SlotHandle{it->second, _generations[it->second]};
+        }
+
+        /**
+         * Getter.
+         * @param handle the handle of the element
+         * @return the element, or nullptr if the element has been erased
+         */
+        T *get(const SlotHandle &handle) const {
+            return valid(handle) ? _slots[handle.index].get() : nullptr;
+        }
+
+        /**
+         * Getter.
+         * @param i the position of the element in insertion order
+         * @return the i-th element
+         */
+        T *operator[](int i) const {
+            compact();
+            return _slots[_order[i].index].get();
+        }
+
+        /**
+         * Getter.
+         * @return all the elements in insertion order
+         */
+        std::vector<T*> values() const {
+            compact();
+            std::vector<T*> res;
+            res.reserve(_order.size());
+            for (auto &handle : _order) {
+                res.push_back(_slots[handle.index].get());
+            }
+            return res;
+        }
+
+        /**
+         * Getter.
+         * @return the number of elements in the map
+         */
+        [[nodiscard]] int size() const {
+            return (int) _indices.size();
+        }
+
+    private:
+        /**
+         * Check whether the handle refers to an element which has not been erased.
+         * @param handle the handle to check
+         * @return true if the handle is valid, false otherwise
+         */
+        bool valid(const SlotHandle &handle) const {
+            return handle.index >= 0 && handle.index < (int) _slots.size() &&
+                _generations[handle.index] == handle.generation && _slots[handle.index] != nullptr;
+        }
+
+        /**
+         * Remove the handles of the erased elements from the insertion order.
+         */
+        void compact() const {
+            if (_tombstones == 0)
+                return;
+            _order.erase(std::remove_if(_order.begin(), _order.end(),
+                                        [this](const SlotHandle &handle){ return !valid(handle); }), _order.end());
+            _tombstones = 0;
+        }
+
+    private:
+        std::vector<std::unique_ptr<T>> _slots;
+        std::vector<unsigned long> _generations;
+        std::vector<int> _free;
+        std::unordered_map<const T*, int> _indices;
+        mutable std::vector<SlotHandle> _order;
+        mutable int _tombstones = 0;
+    };
+
+}
+
+#endif //HOMING_PIGEON_SLOT_MAP_H
@@ -15,22 +15,23 @@ namespace hopi::iterators {
         _currentIndex = 0;
         _currVarIndex = 0;
         _vars = vars;
-        _nHiddenStates = (int) std::count_if(_vars.begin(), _vars.end(), [](const VarNode *elem) {
-            return (elem->type() == VarNodeType::HIDDEN);
-        });
         nextHiddenVar();
     }
 
+    HiddenVarIter::HiddenVarIter(const FactorGraph *fg) {
+        _currentIndex = 0;
+        _currVarIndex = 0;
+        _vars = fg->hiddenNodes();
+    }
+
     void HiddenVarIter::nextHiddenVar() {
-        if (_currentIndex < _nHiddenStates) {
-            while (_currVarIndex < _vars.size() && _vars[_currVarIndex]->type() != VarNodeType::HIDDEN) {
-                ++_currVarIndex;
-            }
+        while (_currVarIndex < _vars.size() && _vars[_currVarIndex]->type() != VarNodeType::HIDDEN) {
+            ++_currVarIndex;
         }
     }
 
     VarNode *HiddenVarIter::operator*() {
-        if (_currentIndex < _nHiddenStates) {
+        if (_currVarIndex < _vars.size()) {
             return _vars[_currVarIndex];
         } else {
             return nullptr;
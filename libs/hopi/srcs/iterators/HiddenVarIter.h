@@ -32,6 +32,13 @@ namespace hopi::iterators {
          */
         explicit HiddenVarIter(const std::vector<nodes::VarNode*>& vars);
 
+        /**
+         * Construct an iterator over the hidden variables of a factor graph, the iterator uses the graph's index of
+         * hidden variables and therefore never visits the observed variables.
+         * @param fg the factor graph on which the iterator will operate
+         */
+        explicit HiddenVarIter(const graphs::FactorGraph *fg);
+
     public:
         /**
          * Getter.
@@ -76,7 +83,6 @@ namespace hopi::iterators {
         std::vector<nodes::VarNode*> _vars;
         int _currentIndex;
         int _currVarIndex;
-        int _nHiddenStates;
     };
 
 }
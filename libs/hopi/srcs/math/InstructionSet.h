@@ -0,0 +1,14 @@
+#ifndef HOMING_PIGEON_INSTRUCTION_SET_H
+#define HOMING_PIGEON_INSTRUCTION_SET_H
+
+namespace hopi::math {
+
+    enum InstructionSet : int {
+        SCALAR = 0, // Portable implementation processing one element at a time
+        AVX2 = 1,   // Four doubles at a time, requires the AVX2 and FMA extensions
+        AVX512 = 2  // Eight doubles at a time, requires the AVX-512 foundation and FMA extensions
+    };
+
+}
+
+#endif //HOMING_PIGEON_INSTRUCTION_SET_H
@@ -6,6 +6,7 @@
 #include <random>
 #include <cmath>
 #include "Ops.h"
+#include "SpecialFunctions.h"
 #include "distributions/Distribution.h"
 #include "api/API.h"
 
@@ -17,6 +18,29 @@ using namespace std;
 
 namespace hopi::math {
 
+    /**
+     * Apply a special function to each element of a tensor. Contiguous CPU tensors of doubles or floats are processed
+     * by the SIMD kernels, other tensors (e.g., tensors on the GPU or requiring gradients) are processed by torch.
+     * @param x the function's inputs
+     * @param kernel the SIMD kernel, called with the input array, the output array and the number of elements
+     * @param fallback the torch implementation of the function
+     * @return the output tensor
+     */
+    template<class Kernel, class Fallback>
+    static Tensor applySpecialFunction(const Tensor &x, const Kernel &kernel, const Fallback &fallback) {
+        if (!x.is_cpu() || x.requires_grad() || (x.scalar_type() != kDouble && x.scalar_type() != kFloat))
+            return fallback(x);
+
+        Tensor in = x.contiguous();
+        Tensor res = torch::empty(in.sizes(), in.options());
+        if (in.scalar_type() == kDouble) {
+            kernel(in.data_ptr<double>(), res.data_ptr<double>(), (size_t) in.numel());
+        } else {
+            kernel(in.data_ptr<float>(), res.data_ptr<float>(), (size_t) in.numel());
+        }
+        return res;
+    }
+
     double Ops::kl(Distribution *d1, Distribution *d2) {
         static map<int, double (*)(Distribution *, Distribution *)> mapping{
                 {DistributionType::CATEGORICAL, &Ops::kl_categorical},
@@ -30,93 +54,86 @@ namespace hopi::math {
     }
 
     double Ops::kl_categorical(Distribution *d1, Distribution *d2) {
-        return (d1->params() * (d1->logParams() - d2->logParams())).sum().item<double>();
-    }
-
-    double Ops::kl_dirichlet(const Tensor &t1, const Tensor &t2) {
-        double kl = 0;
-        auto t1_a = t1.accessor<double,3>();
-        auto t2_a = t2.accessor<double,3>();
-
-        for (int i = 0; i < t1_a.size(0); ++i) {
-            for (int j = 0; j < t1_a.size(1); ++j) {
-                auto sum1 = t1.index({i,j,Ellipsis}).sum().item<double>();
-                auto sum2 = t2.index({i,j,Ellipsis}).sum().item<double>();
-                kl += log_gamma(sum1) - log_gamma(sum2);
-                for (int k = 0; k < t1_a.size(2); ++k) {
-                    kl += log_gamma(t2_a[i][j][k]) \
-                        - log_gamma(t1_a[i][j][k]) \
-                        + (t1_a[i][j][k] - t2_a[i][j][k]) * (digamma(t1_a[i][j][k]) - digamma(sum1));
-                }
-            }
-        }
-        return kl;
+        return (d1->paramsView() * (d1->logParams() - d2->logParams())).sum().item<double>();
+    }
+
+    Tensor Ops::kl_dirichlet(const Tensor &t1, const Tensor &t2) {
+        assert(t1.sizes() == t2.sizes() && "Ops::kl_dirichlet, input must have the same sizes.");
+        Tensor sum1 = t1.sum(-1);
+        Tensor sum2 = t2.sum(-1);
+        Tensor expected_log = digamma(t1) - digamma(sum1.unsqueeze(-1));
+        Tensor terms = log_gamma(t2) - log_gamma(t1) + (t1 - t2) * expected_log;
+        return log_gamma(sum1) - log_gamma(sum2) + terms.sum(-1);
     }
 
     double Ops::kl_dirichlet(Distribution *d1, Distribution *d2) {
-        auto p1 = d1->params();
-        auto p2 = d2->params();
+        const Tensor &p1 = d1->paramsView();
+        const Tensor &p2 = d2->paramsView();
 
         assert(p1.dim() == p2.dim() && "Ops::kl_dirichlet, input must have the same dimension.");
         assert(p1.sizes() == p2.sizes() && "Ops::kl_dirichlet, input must have the same sizes.");
-        Ops::unsqueeze(3 - p1.dim(), {&p1, &p2});
-        return kl_dirichlet(p1, p2);
+        return kl_dirichlet(p1, p2).sum().item<double>();
     }
 
-    double Ops::beta(const Tensor &x) {
-        auto x_a = x.accessor<double,1>();
-        double res = 1;
-        double sum = 0;
+    std::vector<double> Ops::kl_dirichlet(const std::vector<Distribution*> &d1, const std::vector<Distribution*> &d2) {
+        assert(d1.size() == d2.size() && "Ops::kl_dirichlet, the same number of distributions is required.");
+
+        // Group the pairs of distributions by shape
+        std::map<std::vector<int64_t>, std::vector<int>> groups;
+        for (int i = 0; i < d1.size(); ++i) {
+            assert(d1[i]->paramsView().sizes() == d2[i]->paramsView().sizes() && "Ops::kl_dirichlet, input must have the same sizes.");
+            groups[d1[i]->paramsView().sizes().vec()].push_back(i);
+        }
 
-        for (int i = 0; i < x_a.size(0); ++i) {
-            res *= tgamma(x_a[i]);
-            sum += x_a[i];
+        // Compute the KL divergences of each group in one pass
+        std::vector<double> kl(d1.size());
+        for (auto &[shape, indices] : groups) {
+            std::vector<Tensor> p1;
+            std::vector<Tensor> p2;
+            for (int i : indices) {
+                p1.push_back(d1[i]->paramsView());
+                p2.push_back(d2[i]->paramsView());
+            }
+            Tensor res = kl_dirichlet(torch::stack(p1), torch::stack(p2)).reshape({(long) indices.size(), -1}).sum(1).to(kDouble);
+            auto res_a = res.accessor<double,1>();
+            for (int i = 0; i < indices.size(); ++i) {
+                kl[indices[i]] = res_a[i];
+            }
         }
-        return res / tgamma(sum);
+        return kl;
+    }
+
+    double Ops::beta(const Tensor &x) {
+        return exp(log_beta(x));
     }
 
     double Ops::log_beta(const Tensor &x) {
-        return log(beta(x));
+        return log_gamma(x).sum().item<double>() - log_gamma(x.sum().item<double>());
     }
 
     double Ops::log_gamma(double x) {
-        return log(tgamma(x));
+        return SpecialFunctions::lgamma(x);
     }
 
-    double Ops::digamma(double x) {
-        static double c = 8.5;
-        static double euler_mascheroni = 0.57721566490153286060;
-        double r;
-        double value;
-        double x2;
+    Tensor Ops::log_gamma(const Tensor &x) {
+        return applySpecialFunction(
+            x,
+            [](auto in, auto out, size_t n){ SpecialFunctions::lgamma(in, out, n); },
+            [](const Tensor &t){ return torch::lgamma(t); }
+        );
+    }
 
+    double Ops::digamma(double x) {
         assert(x > 0.0 && "Ops::digamma, input must be strictly positive.");
+        return SpecialFunctions::digamma(x);
+    }
 
-        //  Use approximation for small argument.
-        if (x <= 0.000001) {
-            value = -euler_mascheroni - 1.0f / x + 1.6449340668482264365f * x;
-            return value;
-        }
-
-        //  Reduce to digamma(X + N).
-        value = 0.0;
-        x2 = x;
-        while (x2 < c) {
-            value -= 1.0f / x2;
-            x2 += 1.0;
-        }
-
-        //  Use Stirling's (actually de Moivre's) expansion.
-        r = 1.0f / x2;
-        value += log(x2) - 0.5f * r;
-        r = r * r;
-        value -= r * (1.0f / 12.0f
-                      - r * (1.0f / 120.0f
-                             - r * (1.0f / 252.0f
-                                    - r * (1.0f / 240.0f
-                                           - r * (1.0f / 132.0f)))));
-
-        return value;
+    Tensor Ops::digamma(const Tensor &x) {
+        return applySpecialFunction(
+            x,
+            [](auto in, auto out, size_t n){ SpecialFunctions::digamma(in, out, n); },
+            [](const Tensor &t){ return torch::digamma(t); }
+        );
     }
 
     Tensor Ops::one_hot(int size, int index) {
@@ -233,16 +250,16 @@ namespace hopi::math {
     }
 
     int Ops::randomInt(int max) {
-        static std::random_device dev;
-        static std::mt19937 engine(dev());
+        static thread_local std::random_device dev;
+        static thread_local std::mt19937 engine(dev());
         std::uniform_int_distribution<int> rand_int(0, max);
 
         return rand_int(engine);
     }
 
     int Ops::randomInt(const std::vector<double> &weights) {
-        static std::random_device dev;
-        static std::mt19937 engine(dev());
+        static thread_local std::random_device dev;
+        static thread_local std::mt19937 engine(dev());
         std::discrete_distribution<int> rand_int(weights.begin(), weights.end());
 
         return rand_int(engine);
@@ -5,6 +5,7 @@
 #ifndef HOMING_PIGEON_OPS_H
 #define HOMING_PIGEON_OPS_H
 
+#include <vector>
 #include <torch/torch.h>
 
 namespace hopi::distributions {
@@ -47,7 +48,30 @@ namespace hopi::math {
         static double kl_dirichlet(distributions::Distribution *d1, distributions::Distribution *d2);
 
         /**
-         * Compute the logarithm of the generalised beta function.
+         * Compute the Kullback-Leibler (KL) divergences between many pairs of Dirichlet distributions at once. The
+         * pairs whose parameters have the same shape are processed together, in a single pass over their stacked
+         * parameters.
+         * @param d1 the first Dirichlet distribution of each pair
+         * @param d2 the second Dirichlet distribution of each pair
+         * @return the KL divergence of each pair
+         */
+        static std::vector<double> kl_dirichlet(
+                const std::vector<distributions::Distribution*> &d1,
+                const std::vector<distributions::Distribution*> &d2
+        );
+
+        /**
+         * Compute the Kullback-Leibler (KL) divergences between the Dirichlet distributions along the last dimension
+         * of two tensors of parameters, i.e., the i-th row of "t1" is compared to the i-th row of "t2".
+         * @param t1 the first tensor of parameters
+         * @param t2 the second tensor of parameters, which must have the same shape as "t1"
+         * @return the KL divergences, i.e., a tensor with one dimension less than the inputs
+         */
+        static torch::Tensor kl_dirichlet(const torch::Tensor &t1, const torch::Tensor &t2);
+
+        /**
+         * Compute the logarithm of the generalised beta function, without computing the beta function itself so that
+         * large inputs do not overflow.
          * @param x the function's inputs
          * @return the logarithm of the generalised beta function of x
          */
@@ -60,6 +84,13 @@ namespace hopi::math {
          */
         static double log_gamma(double x);
 
+        /**
+         * Compute the logarithm of the gamma function of each element of a tensor.
+         * @param x the function's inputs, which must be strictly positive
+         * @return the logarithm of the gamma function of x
+         */
+        static torch::Tensor log_gamma(const torch::Tensor &x);
+
         /**
          * Compute the beta function.
          * @param x the function's inputs
@@ -74,6 +105,13 @@ namespace hopi::math {
          */
         static double digamma(double x);
 
+        /**
+         * Compute the digamma function of each element of a tensor.
+         * @param x the function's inputs, which must be strictly positive
+         * @return the digamma function of x
+         */
+        static torch::Tensor digamma(const torch::Tensor &x);
+
         //
         // Sampling
         //
@@ -195,21 +233,6 @@ namespace hopi::math {
          * @return the outer tensor product
          */
         static torch::Tensor outer_tensor_product(std::initializer_list<torch::Tensor *> ts);
-
-    private:
-        //
-        // Functions that the final user should never call directly
-        //
-
-        /**
-         * Implement the "hard logic" of the KL divergence between two Dirichlet distributions,
-         * i.e., assuming well formatted inputs.
-         * @param t1 the first 3-tensor of parameters
-         * @param t2 the second 3-tensor of parameters
-         * @return the KL divergence
-         */
-        static double kl_dirichlet(const torch::Tensor &t1, const torch::Tensor &t2);
-
     };
 
 }
@@ -0,0 +1,101 @@
+#include "SpecialFunctions.h"
+#include "SpecialFunctionsKernels.h"
+#include <cassert>
+
+using namespace hopi::math::kernels;
+
+namespace hopi::math {
+
+    /**
+     * Check whether the processor supports an instruction set.
+     * @param isa the instruction set
+     * @return true if the processor supports the instruction set, false otherwise
+     */
+    static bool cpuSupports(const InstructionSet &isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        switch (isa) {
+            case AVX2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            case AVX512:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma");
+            default:
+                return true;
+        }
+#else
+        return isa == SCALAR;
+#endif
+    }
+
+    bool SpecialFunctions::supports(const InstructionSet &isa) {
+        switch (isa) {
+            case AVX2:
+                return avx2Compiled() && cpuSupports(isa);
+            case AVX512:
+                return avx512Compiled() && cpuSupports(isa);
+            default:
+                return true;
+        }
+    }
+
+    InstructionSet SpecialFunctions::bestInstructionSet() {
+        static const InstructionSet best = supports(AVX512) ? AVX512 : supports(AVX2) ? AVX2 : SCALAR;
+        return best;
+    }
+
+    double SpecialFunctions::digamma(double x) {
+        return kernels::digamma<ScalarTraits>(x);
+    }
+
+    double SpecialFunctions::lgamma(double x) {
+        return kernels::lgamma<ScalarTraits>(x);
+    }
+
+    void SpecialFunctions::digamma(const double *x, double *res, std::size_t n, const InstructionSet &isa) {
+        assert(supports(isa) && "SpecialFunctions::digamma, unsupported instruction set");
+        switch (isa) {
+            case AVX512:
+                return digammaAvx512(x, res, n);
+            case AVX2:
+                return digammaAvx2(x, res, n);
+            default:
+                return apply<ScalarTraits, kernels::digamma<ScalarTraits>, kernels::digamma<ScalarTraits>>(x, res, n);
+        }
+    }
+
+    void SpecialFunctions::digamma(const float *x, float *res, std::size_t n, const InstructionSet &isa) {
+        assert(supports(isa) && "SpecialFunctions::digamma, unsupported instruction set");
+        switch (isa) {
+            case AVX512:
+                return digammaAvx512(x, res, n);
+            case AVX2:
+                return digammaAvx2(x, res, n);
+            default:
+                return apply<ScalarTraits, kernels::digamma<ScalarTraits>, kernels::digamma<ScalarTraits>>(x, res, n);
+        }
+    }
+
+    void SpecialFunctions::lgamma(const double *x, double *res, std::size_t n, const InstructionSet &isa) {
+        assert(supports(isa) && "SpecialFunctions::lgamma, unsupported instruction set");
+        switch (isa) {
+            case AVX512:
+                return lgammaAvx512(x, res, n);
+            case AVX2:
+                return lgammaAvx2(x, res, n);
+            default:
+                return apply<ScalarTraits, kernels::lgamma<ScalarTraits>, kernels::lgamma<ScalarTraits>>(x, res, n);
+        }
+    }
+
+    void SpecialFunctions::lgamma(const float *x, float *res, std::size_t n, const InstructionSet &isa) {
+        assert(supports(isa) && "SpecialFunctions::lgamma, unsupported instruction set");
+        switch (isa) {
+            case AVX512:
+                return lgammaAvx512(x, res, n);
+            case AVX2:
+                return lgammaAvx2(x, res, n);
+            default:
+                return apply<ScalarTraits, kernels::lgamma<ScalarTraits>, kernels::lgamma<ScalarTraits>>(x, res, n);
+        }
+    }
+
+}
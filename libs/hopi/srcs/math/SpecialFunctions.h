@@ -0,0 +1,83 @@
+#ifndef HOMING_PIGEON_SPECIAL_FUNCTIONS_H
+#define HOMING_PIGEON_SPECIAL_FUNCTIONS_H
+
+#include <cstddef>
+#include "InstructionSet.h"
+
+namespace hopi::math {
+
+    /**
+     * This class contains the special functions used by the Dirichlet distributions, i.e., the digamma function and
+     * the logarithm of the gamma function. The functions are defined for positive (normal) inputs, and return NaN
+     * for non-positive inputs. Arrays are processed by SIMD kernels, which are selected at runtime according to the
+     * instruction sets supported by the processor. Float arrays are computed in double precision.
+     */
+    class SpecialFunctions {
+    public:
+        /**
+         * Getter.
+         * @return the most efficient instruction set that is both compiled in and supported by the processor
+         */
+        static InstructionSet bestInstructionSet();
+
+        /**
+         * Check whether an instruction set can be used.
+         * @param isa the instruction set
+         * @return true if the instruction set is both compiled in and supported by the processor, false otherwise
+         */
+        static bool supports(const InstructionSet &isa);
+
+        /**
+         * Compute the digamma function of x.
+         * @param x the function's input
+         * @return the digamma function of x
+         */
+        static double digamma(double x);
+
+        /**
+         * Compute the logarithm of the gamma function of x, without overflowing for large x.
+         * @param x the function's input
+         * @return the logarithm of the gamma function of x
+         */
+        static double lgamma(double x);
+
+        /**
+         * Compute the digamma function of each element of an array.
+         * @param x the function's inputs
+         * @param res the array in which the outputs must be written, which may be the input array
+         * @param n the number of elements in the arrays
+         * @param isa the instruction set to use, which must be supported
+         */
+        static void digamma(const double *x, double *res, std::size_t n, const InstructionSet &isa = bestInstructionSet());
+
+        /**
+         * Compute the digamma function of each element of an array.
+         * @param x the function's inputs
+         * @param res the array in which the outputs must be written, which may be the input array
+         * @param n the number of elements in the arrays
+         * @param isa the instruction set to use, which must be supported
+         */
+        static void digamma(const float *x, float *res, std::size_t n, const InstructionSet &isa = bestInstructionSet());
+
+        /**
+         * Compute the logarithm of the gamma function of each element of an array.
+         * @param x the function's inputs
+         * @param res the array in which the outputs must be written, which may be the input array
+         * @param n the number of elements in the arrays
+         * @param isa the instruction set to use, which must be supported
+         */
+        static void lgamma(const double *x, double *res, std::size_t n, const InstructionSet &isa = bestInstructionSet());
+
+        /**
+         * Compute the logarithm of the gamma function of each element of an array.
+         * @param x the function's inputs
+         * @param res the array in which the outputs must be written, which may be the input array
+         * @param n the number of elements in the arrays
+         * @param isa the instruction set to use, which must be supported
+         */
+        static void lgamma(const float *x, float *res, std::size_t n, const InstructionSet &isa = bestInstructionSet());
+    };
+
+}
+
+#endif //HOMING_PIGEON_SPECIAL_FUNCTIONS_H
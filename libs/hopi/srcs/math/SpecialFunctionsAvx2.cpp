@@ -0,0 +1,88 @@
+#include "SpecialFunctionsKernels.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace hopi::math::kernels {
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+    namespace {
+
+        /**
+         * The vector traits of four doubles stored in an AVX register.
+         */
+        struct Avx2Traits {
+            using Vec = __m256d;
+            using Mask = __m256d;
+            static constexpr std::size_t WIDTH = 4;
+
+            static Vec load(const double *x) { return _mm256_loadu_pd(x); }
+            static Vec load(const float *x) { return _mm256_cvtps_pd(_mm_loadu_ps(x)); }
+            static void store(double *x, Vec v) { _mm256_storeu_pd(x, v); }
+            static void store(float *x, Vec v) { _mm_storeu_ps(x, _mm256_cvtpd_ps(v)); }
+            static Vec set(double x) { return _mm256_set1_pd(x); }
+            static Mask lt(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+            static Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); }
+            static bool any(Mask m) { return _mm256_movemask_pd(m) != 0; }
+
+            static Vec log(Vec x) {
+                // Split x into its exponent and its mantissa in [1,2), the biased exponent is converted to double by
+                // adding it to the mantissa of 2^52
+                __m256i bits = _mm256_castpd_si256(x);
+                __m256i two52 = _mm256_castpd_si256(_mm256_set1_pd(0x1p52));
+                Vec e = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), two52)) - set(0x1p52 + 1023);
+                __m256i mantissa = _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+                Vec m = _mm256_castsi256_pd(_mm256_or_si256(mantissa, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+                return logFromParts<Avx2Traits>(m, e);
+            }
+        };
+
+    }
+
+    bool avx2Compiled() {
+        return true;
+    }
+
+    void digammaAvx2(const double *x, double *res, std::size_t n) {
+        apply<Avx2Traits, digamma<Avx2Traits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void digammaAvx2(const float *x, float *res, std::size_t n) {
+        apply<Avx2Traits, digamma<Avx2Traits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx2(const double *x, double *res, std::size_t n) {
+        apply<Avx2Traits, lgamma<Avx2Traits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx2(const float *x, float *res, std::size_t n) {
+        apply<Avx2Traits, lgamma<Avx2Traits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+#else
+
+    bool avx2Compiled() {
+        return false;
+    }
+
+    void digammaAvx2(const double *x, double *res, std::size_t n) {
+        apply<ScalarTraits, digamma<ScalarTraits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void digammaAvx2(const float *x, float *res, std::size_t n) {
+        apply<ScalarTraits, digamma<ScalarTraits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx2(const double *x, double *res, std::size_t n) {
+        apply<ScalarTraits, lgamma<ScalarTraits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx2(const float *x, float *res, std::size_t n) {
+        apply<ScalarTraits, lgamma<ScalarTraits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+#endif
+
+}
@@ -0,0 +1,83 @@
+#include "SpecialFunctionsKernels.h"
+
+#if defined(__AVX512F__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace hopi::math::kernels {
+
+#if defined(__AVX512F__) && defined(__FMA__)
+
+    namespace {
+
+        /**
+         * The vector traits of eight doubles stored in an AVX-512 register.
+         */
+        struct Avx512Traits {
+            using Vec = __m512d;
+            using Mask = __mmask8;
+            static constexpr std::size_t WIDTH = 8;
+
+            static Vec load(const double *x) { return _mm512_loadu_pd(x); }
+            static Vec load(const float *x) { return _mm512_cvtps_pd(_mm256_loadu_ps(x)); }
+            static void store(double *x, Vec v) { _mm512_storeu_pd(x, v); }
+            static void store(float *x, Vec v) { _mm256_storeu_ps(x, _mm512_cvtpd_ps(v)); }
+            static Vec set(double x) { return _mm512_set1_pd(x); }
+            static Mask lt(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+            static Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_blend_pd(m, b, a); }
+            static bool any(Mask m) { return m != 0; }
+
+            static Vec log(Vec x) {
+                Vec m = _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+                Vec e = _mm512_getexp_pd(x);
+                return logFromParts<Avx512Traits>(m, e);
+            }
+        };
+
+    }
+
+    bool avx512Compiled() {
+        return true;
+    }
+
+    void digammaAvx512(const double *x, double *res, std::size_t n) {
+        apply<Avx512Traits, digamma<Avx512Traits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void digammaAvx512(const float *x, float *res, std::size_t n) {
+        apply<Avx512Traits, digamma<Avx512Traits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx512(const double *x, double *res, std::size_t n) {
+        apply<Avx512Traits, lgamma<Avx512Traits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx512(const float *x, float *res, std::size_t n) {
+        apply<Avx512Traits, lgamma<Avx512Traits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+#else
+
+    bool avx512Compiled() {
+        return false;
+    }
+
+    void digammaAvx512(const double *x, double *res, std::size_t n) {
+        apply<ScalarTraits, digamma<ScalarTraits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void digammaAvx512(const float *x, float *res, std::size_t n) {
+        apply<ScalarTraits, digamma<ScalarTraits>, digamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx512(const double *x, double *res, std::size_t n) {
+        apply<ScalarTraits, lgamma<ScalarTraits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+    void lgammaAvx512(const float *x, float *res, std::size_t n) {
+        apply<ScalarTraits, lgamma<ScalarTraits>, lgamma<ScalarTraits>>(x, res, n);
+    }
+
+#endif
+
+}
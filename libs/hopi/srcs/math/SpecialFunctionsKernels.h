@@ -0,0 +1,176 @@
+#ifndef HOMING_PIGEON_SPECIAL_FUNCTIONS_KERNELS_H
+#define HOMING_PIGEON_SPECIAL_FUNCTIONS_KERNELS_H
+
+#include <cmath>
+#include <limits>
+#include <cstddef>
+
+/**
+ * The kernels of the special functions, which are written once for any "vector traits" T, i.e., a class providing:
+ *  - the type of a vector of doubles (Vec) and the type of the result of a comparison (Mask), where Vec supports the
+ *    operators +, -, * and /;
+ *  - the number of doubles in a vector (WIDTH);
+ *  - load and store functions for double and float arrays, set (broadcast), lt (a < b), select (m ? a : b), any
+ *    (true if at least one comparison succeeded) and log.
+ * This header is only included by the translation units implementing the kernels, each of them being compiled for a
+ * specific instruction set. The kernels are therefore declared in an anonymous namespace: each translation unit gets
+ * its own copy compiled with its own flags, and the linker cannot replace the scalar kernels by a copy using
+ * instructions that the processor may not support.
+ */
+namespace hopi::math::kernels {
+
+    namespace {
+
+        /**
+         * The vector traits of a single double, used by the scalar fallback and for the tail of the arrays.
+         */
+        struct ScalarTraits {
+            using Vec = double;
+            using Mask = bool;
+            static constexpr std::size_t WIDTH = 1;
+
+            static Vec load(const double *x) { return *x; }
+            static Vec load(const float *x) { return *x; }
+            static void store(double *x, Vec v) { *x = v; }
+            static void store(float *x, Vec v) { *x = (float) v; }
+            static Vec set(double x) { return x; }
+            static Mask lt(Vec a, Vec b) { return a < b; }
+            static Vec select(Mask m, Vec a, Vec b) { return m ? a : b; }
+            static bool any(Mask m) { return m; }
+            static Vec log(Vec x) { return std::log(x); }
+        };
+
+        /**
+         * Compute the logarithm of 2^e * m from its mantissa m in [1,2) and its exponent e, using the series
+         * log(m) = 2 * atanh((m - 1) / (m + 1)) after reducing m to [sqrt(2)/2, sqrt(2)].
+         * @tparam T the vector traits
+         * @param m the mantissa
+         * @param e the exponent
+         * @return the logarithm
+         */
+        template<class T>
+        typename T::Vec logFromParts(typename T::Vec m, typename T::Vec e) {
+            auto big = T::lt(T::set(1.41421356237309504880), m);
+            m = T::select(big, m * T::set(0.5), m);
+            e = T::select(big, e + T::set(1), e);
+
+            auto s = (m - T::set(1)) / (m + T::set(1));
+            auto s2 = s * s;
+            auto p = T::set(1.0 / 21);
+            p = p * s2 + T::set(1.0 / 19);
+            p = p * s2 + T::set(1.0 / 17);
+            p = p * s2 + T::set(1.0 / 15);
+            p = p * s2 + T::set(1.0 / 13);
+            p = p * s2 + T::set(1.0 / 11);
+            p = p * s2 + T::set(1.0 / 9);
+            p = p * s2 + T::set(1.0 / 7);
+            p = p * s2 + T::set(1.0 / 5);
+            p = p * s2 + T::set(1.0 / 3);
+            p = p * s2 + T::set(1);
+            return e * T::set(0.69314718055994530942) + T::set(2) * s * p;
+        }
+
+        /**
+         * Compute the digamma function, using the recurrence digamma(x) = digamma(x + 1) - 1/x until x >= 10, and
+         * then the asymptotic expansion of the digamma function. The sum of the 1/x terms is accumulated as a single
+         * fraction so that a single division is needed.
+         * @tparam T the vector traits
+         * @param x the function's inputs
+         * @return the digamma function of x
+         */
+        template<class T>
+        typename T::Vec digamma(typename T::Vec x) {
+            auto positive = T::lt(T::set(0), x);
+            x = T::select(positive, x, T::set(1));
+
+            auto num = T::set(0);
+            auto den = T::set(1);
+            auto small = T::lt(x, T::set(10));
+            while (T::any(small)) {
+                num = T::select(small, num * x + den, num);
+                den = T::select(small, den * x, den);
+                x = T::select(small, x + T::set(1), x);
+                small = T::lt(x, T::set(10));
+            }
+
+            auto r = T::set(1) / x;
+            auto r2 = r * r;
+            auto series = r2 * (T::set(1.0 / 12) - r2 * (T::set(1.0 / 120) - r2 * (T::set(1.0 / 252) -
+                r2 * (T::set(1.0 / 240) - r2 * (T::set(1.0 / 132) - r2 * T::set(691.0 / 32760))))));
+            auto res = T::log(x) - T::set(0.5) * r - series - num / den;
+            return T::select(positive, res, T::set(std::numeric_limits<double>::quiet_NaN()));
+        }
+
+        /**
+         * Compute the logarithm of the gamma function, using the recurrence gamma(x) = gamma(x + 1) / x until x >= 10,
+         * and then Stirling's series. The product of the shifted inputs is accumulated so that a single logarithm is
+         * needed.
+         * @tparam T the vector traits
+         * @param x the function's inputs
+         * @return the logarithm of the gamma function of x
+         */
+        template<class T>
+        typename T::Vec lgamma(typename T::Vec x) {
+            auto positive = T::lt(T::set(0), x);
+            x = T::select(positive, x, T::set(1));
+
+            auto prod = T::set(1);
+            auto small = T::lt(x, T::set(10));
+            while (T::any(small)) {
+                prod = T::select(small, prod * x, prod);
+                x = T::select(small, x + T::set(1), x);
+                small = T::lt(x, T::set(10));
+            }
+
+            auto r = T::set(1) / x;
+            auto r2 = r * r;
+            auto series = r * (T::set(1.0 / 12) - r2 * (T::set(1.0 / 360) - r2 * (T::set(1.0 / 1260) -
+                r2 * (T::set(1.0 / 1680) - r2 * (T::set(1.0 / 1188) - r2 * T::set(691.0 / 360360))))));
+            auto res = (x - T::set(0.5)) * T::log(x) - x + T::set(0.91893853320467274178) + series - T::log(prod);
+            return T::select(positive, res, T::set(std::numeric_limits<double>::quiet_NaN()));
+        }
+
+        /**
+         * Apply a kernel to each element of an array, the elements that do not fill a whole vector are processed by
+         * the scalar kernel.
+         * @tparam T the vector traits
+         * @tparam Kernel the vector kernel
+         * @tparam Tail the scalar kernel
+         * @tparam R the type of the array's elements
+         * @param x the inputs
+         * @param res the outputs
+         * @param n the number of elements
+         */
+        template<class T, typename T::Vec (*Kernel)(typename T::Vec), double (*Tail)(double), class R>
+        void apply(const R *x, R *res, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + T::WIDTH <= n; i += T::WIDTH) {
+                T::store(res + i, Kernel(T::load(x + i)));
+            }
+            for (; i < n; ++i) {
+                ScalarTraits::store(res + i, Tail(ScalarTraits::load(x + i)));
+            }
+        }
+
+    }
+
+    //
+    // The kernels compiled for each instruction set, if the instruction set is not compiled in, the functions
+    // fall back to the scalar kernels.
+    //
+
+    bool avx2Compiled();
+    void digammaAvx2(const double *x, double *res, std::size_t n);
+    void digammaAvx2(const float *x, float *res, std::size_t n);
+    void lgammaAvx2(const double *x, double *res, std::size_t n);
+    void lgammaAvx2(const float *x, float *res, std::size_t n);
+
+    bool avx512Compiled();
+    void digammaAvx512(const double *x, double *res, std::size_t n);
+    void digammaAvx512(const float *x, float *res, std::size_t n);
+    void lgammaAvx512(const double *x, double *res, std::size_t n);
+    void lgammaAvx512(const float *x, float *res, std::size_t n);
+
+}
+
+#endif //HOMING_PIGEON_SPECIAL_FUNCTIONS_KERNELS_H
@@ -0,0 +1,16 @@
+#ifndef HOMING_PIGEON_MEMORY_CATEGORY_H
+#define HOMING_PIGEON_MEMORY_CATEGORY_H
+
+namespace hopi::memory {
+
+    enum MemoryCategory : int {
+        NODE_OBJECTS = 0,      // Variable nodes, factor nodes and distribution objects, including names and adjacency
+        POSTERIOR_TENSORS = 1, // Tensors storing the posterior distributions of the variables
+        PARAMETER_TENSORS = 2, // Tensors storing the prior and biased distributions, e.g., the model's parameters
+        PLANNING_DATA = 3,     // Data stored in the nodes by the tree search
+        MESSAGE_CACHES = 4     // Messages and VFE terms cached by the factor nodes
+    };
+
+}
+
+#endif //HOMING_PIGEON_MEMORY_CATEGORY_H
@@ -0,0 +1,49 @@
+#include "MemoryReport.h"
+#include <numeric>
+#include <algorithm>
+
+namespace hopi::memory {
+
+    MemoryReport::MemoryReport() : _bytes(), _peak(0) {}
+
+    void MemoryReport::addBytes(const MemoryCategory &category, std::size_t bytes) {
+        _bytes[category] += bytes;
+    }
+
+    void MemoryReport::addTensor(const MemoryCategory &category, const torch::Tensor &tensor) {
+        if (!tensor.defined() || !tensor.has_storage())
+            return;
+        auto storage = tensor.storage();
+        if (_storages.insert(storage.unsafeGetStorageImpl()).second) {
+            _bytes[category] += storage.nbytes();
+        }
+    }
+
+    void MemoryReport::setPeak(std::size_t bytes) {
+        _peak = bytes;
+    }
+
+    std::size_t MemoryReport::bytes(const MemoryCategory &category) const {
+        return _bytes[category];
+    }
+
+    std::size_t MemoryReport::total() const {
+        return std::accumulate(_bytes.begin(), _bytes.end(), (std::size_t) 0);
+    }
+
+    std::size_t MemoryReport::peak() const {
+        return std::max(_peak, total());
+    }
+
+    void MemoryReport::print(std::ostream &output) const {
+        output << "========== MEMORY REPORT ==========" << std::endl;
+        output << "Node objects: " << bytes(NODE_OBJECTS) << " bytes" << std::endl;
+        output << "Posterior tensors: " << bytes(POSTERIOR_TENSORS) << " bytes" << std::endl;
+        output << "Parameter tensors: " << bytes(PARAMETER_TENSORS) << " bytes" << std::endl;
+        output << "Planning data: " << bytes(PLANNING_DATA) << " bytes" << std::endl;
+        output << "Message caches: " << bytes(MESSAGE_CACHES) << " bytes" << std::endl;
+        output << "Total: " << total() << " bytes (peak: " << peak() << " bytes)" << std::endl;
+        output << std::endl;
+    }
+
+}
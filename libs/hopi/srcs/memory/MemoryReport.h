@@ -0,0 +1,80 @@
+#ifndef HOMING_PIGEON_MEMORY_REPORT_H
+#define HOMING_PIGEON_MEMORY_REPORT_H
+
+#include <array>
+#include <ostream>
+#include <unordered_set>
+#include <torch/torch.h>
+#include "MemoryCategory.h"
+
+namespace hopi::memory {
+
+    /**
+     * A class storing the number of bytes used by a factor graph, by category. The tensors are counted by storage,
+     * i.e., a storage shared by several tensors (e.g., a transition matrix shared by all the slices) is counted only
+     * once, in the category of the first tensor that reported it.
+     */
+    class MemoryReport {
+    public:
+        /**
+         * Constructor.
+         */
+        MemoryReport();
+
+        /**
+         * Add some bytes to a category.
+         * @param category the category using the bytes
+         * @param bytes the number of bytes
+         */
+        void addBytes(const MemoryCategory &category, std::size_t bytes);
+
+        /**
+         * Add the bytes of the tensor's storage to a category, unless the storage has already been counted.
+         * @param category the category using the tensor
+         * @param tensor the tensor
+         */
+        void addTensor(const MemoryCategory &category, const torch::Tensor &tensor);
+
+        /**
+         * Setter.
+         * @param bytes the highest total number of bytes observed so far
+         */
+        void setPeak(std::size_t bytes);
+
+        /**
+         * Getter.
+         * @param category the category whose number of bytes must be returned
+         * @return the number of bytes used by the category
+         */
+        [[nodiscard]] std::size_t bytes(const MemoryCategory &category) const;
+
+        /**
+         * Getter.
+         * @return the total number of bytes used
+         */
+        [[nodiscard]] std::size_t total() const;
+
+        /**
+         * Getter.
+         * @return the highest total number of bytes observed so far, which is at least the current total
+         */
+        [[nodiscard]] std::size_t peak() const;
+
+        /**
+         * Display the report.
+         * @param output the stream on which the report should be displayed
+         */
+        void print(std::ostream &output) const;
+
+    public:
+        static constexpr int N_CATEGORIES = 5;
+
+    private:
+        std::array<std::size_t, N_CATEGORIES> _bytes;
+        std::size_t _peak;
+        std::unordered_set<const void*> _storages;
+    };
+
+}
+
+#endif //HOMING_PIGEON_MEMORY_REPORT_H
@@ -0,0 +1,76 @@
+#include "PoolAllocator.h"
+#include <new>
+
+namespace hopi::memory {
+
+    PoolAllocator &PoolAllocator::instance() {
+        static auto *pool = new PoolAllocator();
+        return *pool;
+    }
+
+    PoolAllocator::PoolAllocator() : _free_lists(), _live_blocks(0), _reserved_bytes(0) {}
+
+    void *PoolAllocator::allocate(std::size_t size) {
+        if (size == 0 || size > MAX_BLOCK_SIZE)
+            return ::operator new(size);
+
+        std::size_t size_class = (size - 1) / ALIGNMENT;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_free_lists[size_class] == nullptr) {
+            refill(size_class);
+        }
+        FreeBlock *block = _free_lists[size_class];
+        _free_lists[size_class] = block->next;
+        ++_live_blocks;
+        return block;
+    }
+
+    void PoolAllocator::deallocate(void *ptr, std::size_t size) {
+        if (ptr == nullptr)
+            return;
+        if (size == 0 || size > MAX_BLOCK_SIZE) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        std::size_t size_class = (size - 1) / ALIGNMENT;
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto *block = static_cast<FreeBlock*>(ptr);
+        block->next = _free_lists[size_class];
+        _free_lists[size_class] = block;
+        --_live_blocks;
+    }
+
+    void PoolAllocator::refill(std::size_t size_class) {
+        std::size_t block_size = (size_class + 1) * ALIGNMENT;
+        std::size_t n_blocks = CHUNK_SIZE / block_size;
+
+        _chunks.emplace_back(new char[n_blocks * block_size]);
+        _reserved_bytes += n_blocks * block_size;
+        char *chunk = _chunks.back().get();
+        for (std::size_t i = n_blocks; i > 0; --i) {
+            auto *block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size);
+            block->next = _free_lists[size_class];
+            _free_lists[size_class] = block;
+        }
+    }
+
+    std::size_t PoolAllocator::liveBlocks() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _live_blocks;
+    }
+
+    std::size_t PoolAllocator::reservedBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _reserved_bytes;
+    }
+
+    void *PoolAllocated::operator new(std::size_t size) {
+        return PoolAllocator::instance().allocate(size);
+    }
+
+    void PoolAllocated::operator delete(void *ptr, std::size_t size) {
+        PoolAllocator::instance().deallocate(ptr, size);
+    }
+
+}
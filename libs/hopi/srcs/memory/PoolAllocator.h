@@ -0,0 +1,110 @@
+#ifndef HOMING_PIGEON_POOL_ALLOCATOR_H
+#define HOMING_PIGEON_POOL_ALLOCATOR_H
+
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+namespace hopi::memory {
+
+    /**
+     * A class implementing a pool allocator for the small objects created in large numbers during planning, i.e.,
+     * nodes, distributions and MCTS data. The memory is requested from the system by large chunks that are divided
+     * into blocks of a fixed size class, and freed blocks are kept in one free list per size class. The memory of
+     * a pruned tree is therefore reused by the next planning step instead of being returned to the system object by
+     * object.
+     */
+    class PoolAllocator {
+    public:
+        /**
+         * Getter. The pool is never destroyed, so that objects released after the end of main can still be
+         * returned to it.
+         * @return the pool shared by all the pooled objects
+         */
+        static PoolAllocator &instance();
+
+        /**
+         * Constructor.
+         */
+        PoolAllocator();
+
+        /**
+         * Allocate a block of memory. Sizes larger than the largest size class are forwarded to the global operator
+         * new.
+         * @param size the number of bytes requested
+         * @return a pointer to the block
+         */
+        void *allocate(std::size_t size);
+
+        /**
+         * Release a block of memory.
+         * @param ptr a pointer to the block
+         * @param size the number of bytes that were requested when the block was allocated
+         */
+        void deallocate(void *ptr, std::size_t size);
+
+        /**
+         * Getter.
+         * @return the number of blocks currently allocated from the pool
+         */
+        [[nodiscard]] std::size_t liveBlocks() const;
+
+        /**
+         * Getter.
+         * @return the number of bytes requested from the system by the pool
+         */
+        [[nodiscard]] std::size_t reservedBytes() const;
+
+    private:
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        /**
+         * Carve a new chunk into blocks and push them on the free list of a size class.
+         * @param size_class the size class that needs more blocks
+         */
+        void refill(std::size_t size_class);
+
+    public:
+        static constexpr std::size_t ALIGNMENT = alignof(std::max_align_t);
+        static constexpr std::size_t MAX_BLOCK_SIZE = 512;
+        static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    private:
+        static constexpr std::size_t N_CLASSES = MAX_BLOCK_SIZE / ALIGNMENT;
+
+        mutable std::mutex _mutex;
+        FreeBlock *_free_lists[N_CLASSES];
+        std::vector<std::unique_ptr<char[]>> _chunks;
+        std::size_t _live_blocks;
+        std::size_t _reserved_bytes;
+    };
+
+    /**
+     * A base class whose derived classes are allocated from the pool allocator when created with new (or
+     * std::make_unique). The base class is empty and does not change the layout of the derived classes, however
+     * classes deleted through a pointer to one of their bases must have a virtual destructor, since the size of
+     * the object is used to find the block's size class.
+     */
+    class PoolAllocated {
+    public:
+        /**
+         * Allocate the memory of an object from the pool.
+         * @param size the size of the object
+         * @return a pointer to the memory
+         */
+        static void *operator new(std::size_t size);
+
+        /**
+         * Return the memory of an object to the pool.
+         * @param ptr a pointer to the memory
+         * @param size the size of the object
+         */
+        static void operator delete(void *ptr, std::size_t size);
+    };
+
+}
+
+#endif //HOMING_PIGEON_POOL_ALLOCATOR_H
@@ -48,7 +48,18 @@ namespace hopi::nodes {
         return to;
     }
 
-    Tensor ActiveTransitionNode::message(VarNode *t) {
+    FactorNodeType ActiveTransitionNode::type() const {
+        return FactorNodeType::ACTIVE_TRANSITION_NODE;
+    }
+
+    std::vector<VarNode *> ActiveTransitionNode::neighbours() {
+        if (B)
+            return {from, action, B, to};
+        else
+            return {from, action, to};
+    }
+
+    Tensor ActiveTransitionNode::computeMessage(VarNode *t) {
         if (t == to) {
             return toMessage();
         } else if (t == from) {
@@ -58,49 +69,80 @@ namespace hopi::nodes {
         } else if (B && t == B) {
             return bMessage();
         } else {
-            assert(false && "ActiveTransitionNode::message, invalid input node.");
+            assert(false && "ActiveTransitionNode::computeMessage, invalid input node.");
         }
     }
 
     Tensor ActiveTransitionNode::toMessage() {
-        Tensor B_bar = Ops::average(getLogB(), action->posterior()->params(), {2});
-        return Ops::average(B_bar, from->posterior()->params(), {1});
+        if (from->posterior()->paramsView().dim() == 2) {
+            // Batched graph, i.e., the posteriors are [batch size, dim] tensors
+            Tensor a_hat = action->posterior()->paramsView();
+            return einsum("tfa,ba,bf->bt", {getLogB(), a_hat, from->posterior()->paramsView()});
+        }
+        Tensor B_bar = Ops::average(getLogB(), action->posterior()->paramsView(), {2});
+        return Ops::average(B_bar, from->posterior()->paramsView(), {1});
     }
 
     Tensor ActiveTransitionNode::fromMessage() {
-        Tensor B_bar = Ops::average(getLogB(), action->posterior()->params(), {2});
-        return Ops::average(B_bar, to->posterior()->params(), {0});
+        if (to->posterior()->paramsView().dim() == 2) {
+            // Batched graph, i.e., the posteriors are [batch size, dim] tensors
+            Tensor a_hat = action->posterior()->paramsView();
+            return einsum("tfa,ba,bt->bf", {getLogB(), a_hat, to->posterior()->paramsView()});
+        }
+        Tensor B_bar = Ops::average(getLogB(), action->posterior()->paramsView(), {2});
+        return Ops::average(B_bar, to->posterior()->paramsView(), {0});
     }
 
     Tensor ActiveTransitionNode::actionMessage() {
-        Tensor B_bar = Ops::average(getLogB(), from->posterior()->params(), {1});
-        return Ops::average(B_bar, to->posterior()->params(), {0});
+        if (to->posterior()->paramsView().dim() == 2) {
+            // Batched graph, i.e., the posteriors are [batch size, dim] tensors
+            Tensor from_hat = from->posterior()->paramsView();
+            return einsum("tfa,bf,bt->ba", {getLogB(), from_hat, to->posterior()->paramsView()});
+        }
+        Tensor B_bar = Ops::average(getLogB(), from->posterior()->paramsView(), {1});
+        return Ops::average(B_bar, to->posterior()->paramsView(), {0});
     }
 
     Tensor ActiveTransitionNode::bMessage() {
-        Tensor to_hat     =     to->posterior()->params();
-        Tensor from_hat   =   from->posterior()->params();
-        Tensor action_hat = action->posterior()->params();
+        Tensor to_hat     =     to->posterior()->paramsView();
+        Tensor from_hat   =   from->posterior()->paramsView();
+        Tensor action_hat = action->posterior()->paramsView();
 
+        if (to_hat.dim() == 2) {
+            // Batched graph, the parameters are shared by all agents, i.e., the message is summed over the batch
+            return einsum("bf,ba,bt->fat", {from_hat, action_hat, to_hat});
+        }
         return Ops::outer_tensor_product({&from_hat,&action_hat,&to_hat});
     }
 
-    double ActiveTransitionNode::vfe() {
-        auto lp       = Ops::average(getLogB(), action->posterior()->params(), {2});
+    double ActiveTransitionNode::computeVfe() {
+        if (to->posterior()->paramsView().dim() == 2) {
+            // Batched graph, the VFE is summed over the batch
+            double VFE = (child()->type() == HIDDEN) ? -child()->posterior()->entropy() : 0;
+            Tensor a_hat = action->posterior()->paramsView();
+            Tensor from_hat = from->posterior()->paramsView();
+            return VFE - einsum("tfa,ba,bf,bt->", {getLogB(), a_hat, from_hat, to->posterior()->paramsView()}).item<double>();
+        }
+        auto lp       = Ops::average(getLogB(), action->posterior()->paramsView(), {2});
         double VFE    = 0;
 
         if (child()->type() == HIDDEN) {
             VFE -= child()->posterior()->entropy();
         }
-        lp = Ops::average(lp, from->posterior()->params(), {1});
-        lp = Ops::average(lp, to->posterior()->params(), {0});
+        lp = Ops::average(lp, from->posterior()->paramsView(), {1});
+        lp = Ops::average(lp, to->posterior()->paramsView(), {0});
         VFE -= lp.item<double>();
         return VFE;
     }
 
+    std::size_t ActiveTransitionNode::objectSize() const {
+        return sizeof(ActiveTransitionNode);
+    }
+
     Tensor ActiveTransitionNode::getLogB() {
         if (B) {
-            return Dirichlet::expectedLog(B->posterior()->params()).permute({2,0,1});
+            assert(B->posterior()->type() == DIRICHLET && "ActiveTransitionNode::getLogB, B must be distributed according to a Dirichlet.");
+            return static_cast<Dirichlet*>(B->posterior())->expectedLog().permute({2,0,1});
         } else {
             return to->prior()->logParams();
         }
@@ -39,36 +39,70 @@ namespace hopi::nodes {
         return childNode;
     }
 
-    Tensor CategoricalNode::message(VarNode *t) {
+    FactorNodeType CategoricalNode::type() const {
+        return FactorNodeType::CATEGORICAL_NODE;
+    }
+
+    std::vector<VarNode *> CategoricalNode::neighbours() {
+        if (D)
+            return {D, childNode};
+        else
+            return {childNode};
+    }
+
+    Tensor CategoricalNode::computeMessage(VarNode *t) {
         if (t == childNode) {
             return childMessage();
         } else if (D && t == D) {
             return dMessage();
         } else {
-            assert(false && "CategoricalNode::message, invalid input node.");
+            assert(false && "CategoricalNode::computeMessage, invalid input node.");
         }
     }
 
     Tensor CategoricalNode::childMessage() {
-        return getLogD();
+        Tensor log_D = getLogD();
+        Tensor child_hat = child()->posterior()->paramsView();
+
+        if (child_hat.dim() == 2) {
+            // Batched graph, the prior may be shared by all agents, i.e., it needs to be expanded along the batch
+            return log_D.expand_as(child_hat);
+        }
+        return log_D;
     }
 
     Tensor CategoricalNode::dMessage() {
-        return child()->posterior()->params();
+        Tensor child_hat = child()->posterior()->paramsView();
+
+        if (child_hat.dim() == 2) {
+            // Batched graph, the parameters are shared by all agents, i.e., the message is summed over the batch
+            return child_hat.sum(0);
+        }
+        return child_hat;
     }
 
-    double CategoricalNode::vfe() {
+    double CategoricalNode::computeVfe() {
         double VFE = 0;
 
         if (child()->type() == HIDDEN) {
             VFE -= child()->posterior()->entropy();
         }
-        return VFE - dot(child()->posterior()->params(), getLogD()).item<double>();
+        Tensor child_hat = child()->posterior()->paramsView();
+        if (child_hat.dim() == 2) {
+            // Batched graph, the VFE is summed over the batch
+            return VFE - (child_hat * getLogD()).sum().item<double>();
+        }
+        return VFE - dot(child_hat, getLogD()).item<double>();
+    }
+
+    std::size_t CategoricalNode::objectSize() const {
+        return sizeof(CategoricalNode);
     }
 
     Tensor CategoricalNode::getLogD() {
         if (D) {
-            return Dirichlet::expectedLog(D->posterior()->params());
+            assert(D->posterior()->type() == DIRICHLET && "CategoricalNode::getLogD, D must be distributed according to a Dirichlet.");
+            return static_cast<Dirichlet*>(D->posterior())->expectedLog();
         } else {
             return child()->prior()->logParams();
         }
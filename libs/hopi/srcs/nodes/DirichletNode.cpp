@@ -4,12 +4,10 @@
 
 #include "DirichletNode.h"
 #include "VarNode.h"
-#include "distributions/Distribution.h"
-#include "math/Ops.h"
+#include "distributions/Dirichlet.h"
 
 using namespace torch;
-using namespace torch::indexing;
-using namespace hopi::math;
+using namespace hopi::distributions;
 
 namespace hopi::nodes {
 
@@ -29,47 +27,46 @@ namespace hopi::nodes {
         return childNode;
     }
 
-    Tensor DirichletNode::message(VarNode *to) {
+    FactorNodeType DirichletNode::type() const {
+        return FactorNodeType::DIRICHLET_NODE;
+    }
+
+    std::vector<VarNode *> DirichletNode::neighbours() {
+        return {childNode};
+    }
+
+    Tensor DirichletNode::computeMessage(VarNode *to) {
         if (to == childNode) {
             return childMessage();
         } else {
-            assert(false && "DirichletNode::message, invalid input node.");
+            assert(false && "DirichletNode::computeMessage, invalid input node.");
         }
     }
 
-    double DirichletNode::energy(const Tensor &prior, const Tensor &post) {
-        auto sum = post.sum().item<double>();
-        double acc = 0;
-
-        assert(prior.dim() == 1 && "DirichletNode::energy, prior must have dimension one.");
-        assert(post.dim() == 1 && "DirichletNode::energy, post must have dimension one.");
-        for (int k = 0; k < post.size(0); ++k) {
-            acc += (prior[k].item<double>() - 1) *  (Ops::digamma(post[k].item<double>()) - Ops::digamma(sum));
-        }
-        return acc - Ops::log_beta(prior);
+    double DirichletNode::energy(const Tensor &prior, const Tensor &expected_log) {
+        return ((prior - 1) * expected_log).sum().item<double>() - Dirichlet::logBeta(prior).sum().item<double>();
     }
 
-    double DirichletNode::vfe() {
+    double DirichletNode::computeVfe() {
         double VFE = 0;
-        Tensor post_p  = child()->posterior()->params();
-        Tensor prior_p = child()->prior()->params();
+        const Tensor &post_p  = child()->posterior()->paramsView();
+        const Tensor &prior_p = child()->prior()->paramsView();
 
-        assert(prior_p.dim() == post_p.dim() && "DirichletNode::vfe, post and prior parameters must have the same dimension");
-        assert(prior_p.sizes() == post_p.sizes() && "DirichletNode::vfe, post and prior parameters must have the same sizes");
+        assert(prior_p.dim() == post_p.dim() && "DirichletNode::computeVfe, post and prior parameters must have the same dimension");
+        assert(prior_p.sizes() == post_p.sizes() && "DirichletNode::computeVfe, post and prior parameters must have the same sizes");
+        assert(child()->posterior()->type() == DIRICHLET && "DirichletNode::computeVfe, the posterior must be a Dirichlet.");
         if (child()->type() == HIDDEN) {
             VFE -= child()->posterior()->entropy();
         }
-        Ops::unsqueeze(3 - prior_p.dim(), {&prior_p,&post_p});
-        for (int i = 0; i < post_p.size(0); ++i) {
-            for (int j = 0; j < post_p.size(1); ++j) {
-                VFE -= energy(prior_p.index({i,j,Ellipsis}), post_p.index({i,j,Ellipsis}));
-            }
-        }
-        return VFE;
+        return VFE - energy(prior_p, static_cast<Dirichlet*>(child()->posterior())->expectedLog());
+    }
+
+    std::size_t DirichletNode::objectSize() const {
+        return sizeof(DirichletNode);
     }
 
     Tensor DirichletNode::childMessage() {
-        return childNode->prior()->params();
+        return childNode->prior()->paramsView();
     }
 
 }
@@ -60,26 +60,44 @@ namespace hopi::nodes {
         VarNode *child() const override;
 
         /**
-         * Compute the message towards a specific node
+         * Getter.
+         * @return the factor's type
+         */
+        [[nodiscard]] FactorNodeType type() const override;
+
+        /**
+         * Getter.
+         * @return all the variables connected to the factor, i.e., its (non-null) parents and its child.
+         */
+        std::vector<VarNode *> neighbours() override;
+
+        /**
+         * Compute the message towards a specific node from scratch, i.e., ignoring the cache.
          * @param to the node toward which the message is sent
          * @return the message
          */
-        torch::Tensor message(VarNode *to) override;
+        torch::Tensor computeMessage(VarNode *to) override;
 
         /**
-         * Compute the Variational Free Energy (VFE) of the factor
+         * Compute the Variational Free Energy (VFE) of the factor from scratch, i.e., ignoring the cache.
          * @return the VFE
          */
-        double vfe() override;
+        double computeVfe() override;
+
+        /**
+         * Getter.
+         * @return the size of the factor object in bytes
+         */
+        [[nodiscard]] std::size_t objectSize() const override;
 
     private:
         /**
-         * Compute the energy of the factor.
+         * Compute the energy of the factor, i.e., the sum of the energies of all the Dirichlet along the last dimension.
          * @param prior parameters of the prior distribution
-         * @param post parameters of the posterior distribution
+         * @param expected_log expectation of the logarithm of x under the posterior distribution
          * @return the energy of the factor
          */
-        static double energy(const torch::Tensor &prior, const torch::Tensor &post);
+        static double energy(const torch::Tensor &prior, const torch::Tensor &expected_log);
 
         /**
          * Getter.
@@ -3,9 +3,60 @@
 //
 
 #include "nodes/FactorNode.h"
+#include "nodes/VarNode.h"
+#include "distributions/Distribution.h"
+#include <algorithm>
+
+using namespace hopi::distributions;
 
 namespace hopi::nodes {
 
+    double FactorNode::vfe() {
+        auto version = inputsVersion();
+
+        if (version != _vfeVersion) {
+            _vfe = computeVfe();
+            _vfeVersion = std::move(version);
+        }
+        return _vfe;
+    }
+
+    torch::Tensor FactorNode::message(VarNode *to) {
+        // Messages towards the parameters are as large as the parameters themselves (e.g., S x S x A for a transition
+        // mapping), and are only consumed once per update of the parameters, so caching them would waste memory
+        Distribution *d = (to->posterior() != nullptr) ? to->posterior() : to->prior();
+        if (d != nullptr && d->type() == DistributionType::DIRICHLET) {
+            return computeMessage(to);
+        }
+
+        auto version = inputsVersion(to);
+        auto entry = std::find_if(_messages.begin(), _messages.end(), [to](const auto &m) {
+            return std::get<0>(m) == to;
+        });
+
+        if (entry == _messages.end()) {
+            _messages.emplace_back(to, std::move(version), computeMessage(to));
+            return std::get<2>(_messages.back());
+        }
+        if (std::get<1>(*entry) != version) {
+            std::get<2>(*entry) = computeMessage(to);
+            std::get<1>(*entry) = std::move(version);
+        }
+        return std::get<2>(*entry);
+    }
+
+    std::vector<long> FactorNode::inputsVersion(VarNode *to) {
+        std::vector<long> version;
+
+        for (auto var : neighbours()) {
+            for (Distribution *d : {var->prior(), var->posterior()}) {
+                version.push_back((d == nullptr || (var == to && d == var->posterior())) ? 0 : d->version());
+            }
+        }
+        version.push_back(child()->type());
+        return version;
+    }
+
     std::string FactorNode::name() const {
         return _name;
     }
@@ -18,4 +69,17 @@ namespace hopi::nodes {
         _name = name;
     }
 
+    void FactorNode::reportMemory(memory::MemoryReport &report) const {
+        report.addBytes(memory::NODE_OBJECTS, objectSize());
+        if (_name.capacity() > std::string().capacity()) {
+            report.addBytes(memory::NODE_OBJECTS, _name.capacity() + 1);
+        }
+        report.addBytes(memory::MESSAGE_CACHES, _vfeVersion.capacity() * sizeof(long));
+        report.addBytes(memory::MESSAGE_CACHES, _messages.capacity() * sizeof(_messages[0]));
+        for (auto &message : _messages) {
+            report.addBytes(memory::MESSAGE_CACHES, std::get<1>(message).capacity() * sizeof(long));
+            report.addTensor(memory::MESSAGE_CACHES, std::get<2>(message));
+        }
+    }
+
 }
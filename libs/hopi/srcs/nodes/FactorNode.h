@@ -6,6 +6,11 @@
 #define HOMING_PIGEON_FACTOR_NODE_H
 
 #include <torch/torch.h>
+#include <vector>
+#include <tuple>
+#include "FactorNodeType.h"
+#include "memory/PoolAllocator.h"
+#include "memory/MemoryReport.h"
 
 namespace hopi::nodes {
     class VarNode;
@@ -16,8 +21,19 @@ namespace hopi::nodes {
     /**
      * Interface representing a general factor node.
      */
-    class FactorNode {
+    class FactorNode : public memory::PoolAllocated {
     public:
+        /**
+         * Destructor.
+         */
+        virtual ~FactorNode() = default;
+
+        /**
+         * Getter.
+         * @return the factor's type
+         */
+        [[nodiscard]] virtual FactorNodeType type() const = 0;
+
         /**
          * Getter.
          * @param i the index of the parent that must be returned
@@ -32,17 +48,46 @@ namespace hopi::nodes {
         virtual VarNode *child() const = 0;
 
         /**
-         * Compute the message towards a specific node
+         * Getter.
+         * @return all the variables connected to the factor, i.e., its (non-null) parents and its child.
+         */
+        virtual std::vector<VarNode *> neighbours() = 0;
+
+        /**
+         * Compute the message towards a specific node. The message is cached, and only re-computed if the
+         * distributions of the other adjacent variables changed since the last call. The returned tensor shares its
+         * storage with the cache, and must therefore not be modified in place. Messages towards Dirichlet (parameter)
+         * nodes are not cached, because they are as large as the parameters and only consumed once per update.
+         * @param to the node toward which the message is sent
+         * @return the message
+         */
+        torch::Tensor message(VarNode *to);
+
+        /**
+         * Compute the message towards a specific node from scratch, i.e., ignoring the cache.
          * @param to the node toward which the message is sent
          * @return the message
          */
-        virtual torch::Tensor message(VarNode *to) = 0;
+        virtual torch::Tensor computeMessage(VarNode *to) = 0;
 
         /**
-         * Compute the Variational Free Energy (VFE) of the factor
+         * Compute the Variational Free Energy (VFE) of the factor. The VFE is cached, and only re-computed if the
+         * distributions or the type of one of the adjacent variables changed since the last call.
          * @return the VFE
          */
-        virtual double vfe() = 0;
+        double vfe();
+
+        /**
+         * Compute the Variational Free Energy (VFE) of the factor from scratch, i.e., ignoring the cache.
+         * @return the VFE
+         */
+        virtual double computeVfe() = 0;
+
+        /**
+         * Getter.
+         * @return the size of the factor object in bytes, i.e., the size of the concrete factor class
+         */
+        [[nodiscard]] virtual std::size_t objectSize() const = 0;
 
         /**
          * Getter.
@@ -62,8 +107,26 @@ namespace hopi::nodes {
          */
         void setName(std::string &&name);
 
+        /**
+         * Add the memory used by the factor to a report, i.e., the factor itself and its cached messages.
+         * @param report the report in which the memory must be added
+         */
+        void reportMemory(memory::MemoryReport &report) const;
+
+    private:
+        /**
+         * Getter.
+         * @param to the node toward which a message is sent, the version of its posterior is ignored because the
+         * message does not depend on it (nullptr if all the versions must be returned)
+         * @return the versions of the distributions of the adjacent variables, as well as the type of the child
+         */
+        std::vector<long> inputsVersion(VarNode *to = nullptr);
+
     private:
         std::string _name;
+        std::vector<long> _vfeVersion;
+        double _vfe = 0;
+        std::vector<std::tuple<VarNode*, std::vector<long>, torch::Tensor>> _messages;
     };
 
 }
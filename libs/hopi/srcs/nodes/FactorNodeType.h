@@ -0,0 +1,15 @@
+#ifndef HOMING_PIGEON_FACTOR_NODE_TYPE_H
+#define HOMING_PIGEON_FACTOR_NODE_TYPE_H
+
+namespace hopi::nodes {
+
+    enum FactorNodeType : int {
+        CATEGORICAL_NODE,       // P(x)     = Cat(param)
+        TRANSITION_NODE,        // P(x|y)   = Cat(param)
+        ACTIVE_TRANSITION_NODE, // P(x|y,z) = Cat(param)
+        DIRICHLET_NODE          // P(x)     = Dir(param)
+    };
+
+}
+
+#endif //HOMING_PIGEON_FACTOR_NODE_TYPE_H
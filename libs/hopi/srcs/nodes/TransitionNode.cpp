@@ -44,7 +44,18 @@ namespace hopi::nodes {
         return to;
     }
 
-    Tensor TransitionNode::message(VarNode *t) {
+    FactorNodeType TransitionNode::type() const {
+        return FactorNodeType::TRANSITION_NODE;
+    }
+
+    std::vector<VarNode *> TransitionNode::neighbours() {
+        if (A)
+            return {from, A, to};
+        else
+            return {from, to};
+    }
+
+    Tensor TransitionNode::computeMessage(VarNode *t) {
         if (t == to) {
             return toMessage();
         } else if (t == from) {
@@ -52,35 +63,64 @@ namespace hopi::nodes {
         } else if (A && t == A) {
             return aMessage();
         } else {
-            assert(false && "TransitionNode::message, invalid input node.");
+            assert(false && "TransitionNode::computeMessage, invalid input node.");
         }
     }
 
     Tensor TransitionNode::toMessage() {
-        return matmul(getLogA(), from->posterior()->params());
+        Tensor from_hat = from->posterior()->paramsView();
+
+        if (from_hat.dim() == 2) {
+            // Batched graph, i.e., from_hat is a [batch size, dim] tensor
+            return matmul(from_hat, getLogA().permute({1,0}));
+        }
+        return matmul(getLogA(), from_hat);
     }
 
     Tensor TransitionNode::fromMessage() {
-        return matmul(getLogA().permute({1,0}), to->posterior()->params());
+        Tensor to_hat = to->posterior()->paramsView();
+
+        if (to_hat.dim() == 2) {
+            // Batched graph, i.e., to_hat is a [batch size, dim] tensor
+            return matmul(to_hat, getLogA());
+        }
+        return matmul(getLogA().permute({1,0}), to_hat);
     }
 
     Tensor TransitionNode::aMessage() {
-        return outer(from->posterior()->params(), to->posterior()->params());
+        Tensor from_hat = from->posterior()->paramsView();
+
+        if (from_hat.dim() == 2) {
+            // Batched graph, the parameters are shared by all agents, i.e., the message is summed over the batch
+            return matmul(from_hat.permute({1,0}), to->posterior()->paramsView());
+        }
+        return outer(from_hat, to->posterior()->paramsView());
     }
 
-    double TransitionNode::vfe() {
+    double TransitionNode::computeVfe() {
         double VFE = 0;
 
         if (child()->type() == HIDDEN) {
             VFE -= child()->posterior()->entropy();
         }
-        auto lp = Ops::average(getLogA(), from->posterior()->params(), {1});
-        return VFE - Ops::average(lp, to->posterior()->params(), {0}).item<double>();
+        Tensor from_hat = from->posterior()->paramsView();
+        if (from_hat.dim() == 2) {
+            // Batched graph, the VFE is summed over the batch
+            auto lp = matmul(from_hat, getLogA().permute({1,0}));
+            return VFE - (lp * to->posterior()->paramsView()).sum().item<double>();
+        }
+        auto lp = Ops::average(getLogA(), from_hat, {1});
+        return VFE - Ops::average(lp, to->posterior()->paramsView(), {0}).item<double>();
+    }
+
+    std::size_t TransitionNode::objectSize() const {
+        return sizeof(TransitionNode);
     }
 
     Tensor TransitionNode::getLogA() {
         if (A) {
-            return Dirichlet::expectedLog(A->posterior()->params()).permute({1,0});
+            assert(A->posterior()->type() == DIRICHLET && "TransitionNode::getLogA, A must be distributed according to a Dirichlet.");
+            return static_cast<Dirichlet*>(A->posterior())->expectedLog().permute({1,0});
         } else {
             return to->prior()->logParams();
         }
@@ -7,9 +7,11 @@
 #include <utility>
 #include "distributions/Distribution.h"
 #include "algorithms/planning/MCTSNodeData.h"
+#include "graphs/FactorGraph.h"
 
 using namespace hopi::distributions;
 using namespace hopi::algorithms::planning;
+using namespace hopi::graphs;
 
 namespace hopi::nodes {
 
@@ -17,10 +19,14 @@ namespace hopi::nodes {
         return std::make_unique<VarNode>(type);
     }
 
+    struct VarNode::Extras : public memory::PoolAllocated {
+        std::string name;
+        std::unique_ptr<Distribution> biased; // Prior preferences
+    };
+
     VarNode::VarNode(VarNodeType type) :
-        _type(type), _parent(nullptr), _prior(nullptr), _posterior(nullptr), _biased(nullptr) {
-        _data = MCTSNodeData::create();
-    }
+        _data(nullptr), _extras(nullptr), _parent(nullptr), _prior(nullptr), _posterior(nullptr), _graph(nullptr),
+        _type(type) {}
 
     VarNode::~VarNode() = default;
 
@@ -33,7 +39,9 @@ namespace hopi::nodes {
     }
 
     void VarNode::setBiased(std::unique_ptr<Distribution> b) {
-        _biased = std::move(b);
+        if (b == nullptr && _extras == nullptr)
+            return;
+        extras().biased = std::move(b);
     }
 
     void VarNode::setParent(FactorNode *p) {
@@ -57,7 +65,7 @@ namespace hopi::nodes {
     }
 
     Distribution *VarNode::biased() const {
-        return _biased.get();
+        return (_extras == nullptr) ? nullptr : _extras->biased.get();
     }
 
     int VarNode::nChildren() const {
@@ -72,8 +80,20 @@ namespace hopi::nodes {
         return _prior.get();
     }
 
+    void VarNode::setGraph(FactorGraph *graph) {
+        _graph = graph;
+    }
+
+    FactorGraph *VarNode::graph() const {
+        return _graph;
+    }
+
     void VarNode::setType(VarNodeType type) {
+        VarNodeType old_type = _type;
         _type = type;
+        if (_graph != nullptr) {
+            _graph->onTypeChanged(this, old_type);
+        }
     }
 
     void VarNode::addChild(FactorNode *c) {
@@ -81,21 +101,50 @@ namespace hopi::nodes {
     }
 
     void VarNode::setName(std::string &name) {
-        _name = name;
+        if (name.empty() && _extras == nullptr)
+            return;
+        std::string old_name = std::move(extras().name);
+        _extras->name = name;
+        if (_graph != nullptr) {
+            _graph->onNameChanged(this, old_name);
+        }
     }
 
     void VarNode::setName(std::string &&name) {
-        _name = name;
+        setName(name);
     }
 
     std::string VarNode::name() const {
-        return _name;
+        return (_extras == nullptr) ? std::string() : _extras->name;
+    }
+
+    VarNode::Extras &VarNode::extras() {
+        if (_extras == nullptr) {
+            _extras = std::make_unique<Extras>();
+        }
+        return *_extras;
     }
 
     MCTSNodeData *VarNode::data() const {
+        if (_data == nullptr) {
+            _data = MCTSNodeData::create();
+        }
         return _data.get();
     }
 
+    bool VarNode::hasData() const {
+        return _data != nullptr;
+    }
+
+    const MCTSNodeData &VarNode::dataOrDefault() const {
+        static const MCTSNodeData defaults;
+        return (_data == nullptr) ? defaults : *_data;
+    }
+
+    int VarNode::action() const {
+        return (_data == nullptr) ? -1 : _data->action;
+    }
+
     void VarNode::removeNullChildren() {
         _children.erase(std::remove_if(_children.begin(), _children.end(),
                                        [](FactorNode * &x){return x == nullptr;}), _children.end());
@@ -116,8 +165,31 @@ namespace hopi::nodes {
 
     int VarNode::nChildrenHiddenStates() const {
         return (int) std::count_if(_children.begin(), _children.end(), [](FactorNode *node) {
-            return node->child()->data()->action != -1;
+            return node->child()->action() != -1;
         });
     }
 
+    void VarNode::reportMemory(memory::MemoryReport &report) const {
+        report.addBytes(memory::NODE_OBJECTS, sizeof(VarNode));
+        report.addBytes(memory::NODE_OBJECTS, _children.capacity() * sizeof(FactorNode*));
+        if (_extras) {
+            report.addBytes(memory::NODE_OBJECTS, sizeof(Extras));
+            if (_extras->name.capacity() > std::string().capacity()) {
+                report.addBytes(memory::NODE_OBJECTS, _extras->name.capacity() + 1);
+            }
+            if (_extras->biased) {
+                _extras->biased->reportMemory(report, memory::PARAMETER_TENSORS);
+            }
+        }
+        if (_data) {
+            report.addBytes(memory::PLANNING_DATA, sizeof(MCTSNodeData));
+        }
+        if (_posterior) {
+            _posterior->reportMemory(report, memory::POSTERIOR_TENSORS);
+        }
+        if (_prior) {
+            _prior->reportMemory(report, memory::PARAMETER_TENSORS);
+        }
+    }
+
 }
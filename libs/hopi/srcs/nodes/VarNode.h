@@ -6,6 +6,8 @@
 #define HOMING_PIGEON_VAR_NODE_H
 
 #include "VarNodeType.h"
+#include "memory/PoolAllocator.h"
+#include "memory/MemoryReport.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -19,13 +21,18 @@ namespace hopi::nodes {
 namespace hopi::algorithms::planning {
     class MCTSNodeData;
 }
+namespace hopi::graphs {
+    class FactorGraph;
+}
 
 namespace hopi::nodes {
 
     /**
-     * Class representing a variable node.
+     * Class representing a variable node. To keep the nodes small, the data used by the planner, the node's name and
+     * its biased distribution are only allocated when they are used, since most nodes (e.g., observations and
+     * parameters) never need them.
      */
-    class VarNode {
+    class VarNode : public memory::PoolAllocated {
     public:
         /**
          * Create a variable node.
@@ -70,6 +77,13 @@ namespace hopi::nodes {
          */
         void setParent(FactorNode *parent);
 
+        /**
+         * Setter.
+         * @param graph the factor graph that owns the node, and which must be notified when the node's type or name
+         * changes
+         */
+        void setGraph(graphs::FactorGraph *graph);
+
         /**
          * Setter.
          * @param type the new type of the node
@@ -144,10 +158,35 @@ namespace hopi::nodes {
 
         /**
          * Getter.
-         * @return the node's data
+         * @return the factor graph that owns the node, or nullptr if the node has not been added to a graph
+         */
+        [[nodiscard]] graphs::FactorGraph *graph() const;
+
+        /**
+         * Getter.
+         * @return the node's data, which are allocated on the first call
          */
         [[nodiscard]] algorithms::planning::MCTSNodeData *data() const;
 
+        /**
+         * Getter.
+         * @return true if the node's data have been allocated, false otherwise
+         */
+        [[nodiscard]] bool hasData() const;
+
+        /**
+         * Getter.
+         * @return the node's data, or the default data if they have not been allocated, which are not allocated by
+         * this function
+         */
+        [[nodiscard]] const algorithms::planning::MCTSNodeData &dataOrDefault() const;
+
+        /**
+         * Getter.
+         * @return the action that led to the node, or -1 if the node is not a hidden state of the planning tree
+         */
+        [[nodiscard]] int action() const;
+
         /**
          * Getter.
          * @return the node's prior distribution
@@ -178,14 +217,33 @@ namespace hopi::nodes {
          */
         void disconnectChild(nodes::FactorNode *node);
 
+        /**
+         * Add the memory used by the node to a report, i.e., the node itself, its planning data and its distributions.
+         * The factors of the node are not reported.
+         * @param report the report in which the memory must be added
+         */
+        void reportMemory(memory::MemoryReport &report) const;
+
+    private:
+        /**
+         * The attributes that most nodes do not use, i.e., the node's name and its biased distribution.
+         */
+        struct Extras;
+
+        /**
+         * Getter.
+         * @return the node's extra attributes, which are allocated on the first call
+         */
+        Extras &extras();
+
     private:
-        std::unique_ptr<algorithms::planning::MCTSNodeData> _data;
+        mutable std::unique_ptr<algorithms::planning::MCTSNodeData> _data;
+        std::unique_ptr<Extras> _extras;
         std::vector<FactorNode *> _children;
         FactorNode *_parent;
-        std::string _name;
         std::unique_ptr<distributions::Distribution> _prior;
         std::unique_ptr<distributions::Distribution> _posterior; // Evidence for OBSERVED variables
-        std::unique_ptr<distributions::Distribution> _biased;    // Prior preferences
+        graphs::FactorGraph *_graph;
         VarNodeType _type;
     };
 
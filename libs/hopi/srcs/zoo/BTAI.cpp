@@ -3,12 +3,16 @@
 //
 
 #include "BTAI.h"
+#include "BTAIConfig.h"
 #include "algorithms/planning/MCTSConfig.h"
 #include "algorithms/planning/MCTS.h"
 #include "algorithms/planning/MCTSNodeData.h"
 #include "algorithms/inference/VMP.h"
+#include "algorithms/inference/ForwardBackward.h"
 #include "distributions/Categorical.h"
 #include "graphs/FactorGraph.h"
+#include "graphs/GraphContext.h"
+#include "graphs/Checkpoint.h"
 #include "nodes/VarNode.h"
 #include "environments/Environment.h"
 #include "api/API.h"
@@ -27,15 +31,17 @@ namespace hopi::zoo {
     std::shared_ptr<BTAI> BTAI::create(
             const Environment *env,
             const std::shared_ptr<MCTSConfig> &config,
-            const Tensor &obs
+            const Tensor &obs,
+            const std::shared_ptr<BTAIConfig> &inference_config
     ) {
-        return std::make_shared<BTAI>(env, config, obs);
+        return std::make_shared<BTAI>(env, config, obs, inference_config);
     }
 
     BTAI::BTAI(
             const Environment *env,
             const std::shared_ptr<MCTSConfig> &config,
-            const Tensor &obs
+            const Tensor &obs,
+            const std::shared_ptr<BTAIConfig> &inference_config
     ) {
         // Retrieve current factor graph.
         _fg = FactorGraph::current();
@@ -56,6 +62,46 @@ namespace hopi::zoo {
 
         // Create the MCTS algorithm.
         _mcts = MCTS::create(config);
+        _config = (inference_config == nullptr) ? BTAIConfig::create() : inference_config;
+    }
+
+    BTAI::BTAI(
+            const std::shared_ptr<FactorGraph> &fg,
+            const Tensor &a,
+            const Tensor &b,
+            const Tensor &d,
+            const std::shared_ptr<MCTSConfig> &config,
+            const std::shared_ptr<BTAIConfig> &inference_config
+    ) : _a(a), _b(b), _d(d), _fg(fg) {
+        _mcts = MCTS::create(config);
+        _config = (inference_config == nullptr) ? BTAIConfig::create() : inference_config;
+    }
+
+    std::shared_ptr<BTAI> BTAI::load(
+            const std::string &file_name,
+            const std::shared_ptr<MCTSConfig> &config,
+            const std::shared_ptr<BTAIConfig> &inference_config
+    ) {
+        std::map<std::string, Tensor> model;
+        auto fg = Checkpoint::load(file_name, &model);
+        if (model.count("A") == 0 || model.count("B") == 0 || model.count("D") == 0) {
+            throw std::runtime_error("In BTAI::load, the checkpoint does not contain a BTAI agent.");
+        }
+        return std::make_shared<BTAI>(fg, model["A"], model["B"], model["D"], config, inference_config);
+    }
+
+    void BTAI::save(const std::string &file_name) {
+        Checkpoint::save(file_name, _fg.get(), {{"A", _a}, {"B", _b}, {"D", _d}});
+    }
+
+    memory::MemoryReport BTAI::memory() const {
+        auto report = _fg->memory();
+        report.addBytes(memory::NODE_OBJECTS, sizeof(BTAI));
+        report.addBytes(memory::PLANNING_DATA, sizeof(MCTS));
+        report.addTensor(memory::PARAMETER_TENSORS, _a);
+        report.addTensor(memory::PARAMETER_TENSORS, _b);
+        report.addTensor(memory::PARAMETER_TENSORS, _d);
+        return report;
     }
 
     BTAI::~BTAI() {
@@ -64,11 +110,23 @@ namespace hopi::zoo {
     }
 
     void BTAI::step(const std::shared_ptr<Environment> &env, const EvaluationType &type) {
-        VMP::inference(_fg->getNodes());
+        // Make sure that the nodes created by the planning and the integration are added to the agent's graph
+        GraphContext context(_fg);
+
+        // The exact smoothing is only performed on demand, since its cost grows with the length of the chain while
+        // the residual updates only touch the nodes around the last slice
+        if (!_config->smoothing() || !ForwardBackward::inference(_fg)) {
+            if (_config->schedule() == RESIDUAL) {
+                VMP::incrementalInference(_fg, _config->epsilon());
+            } else {
+                VMP::inference(_fg->getNodes(), _config->schedule(), _config->epsilon());
+                _fg->clearDirty();
+            }
+        }
         for (int j = 0; j < _mcts->config()->nbPlanningSteps(); ++j) {
             auto selectedNode = _mcts->selectNode(_fg->treeRoot(), env->actions());
             auto expandedNodes = _mcts->expansion(selectedNode, _a, _b);
-            VMP::inference(expandedNodes);
+            MCTS::prediction(expandedNodes);
             _mcts->evaluation(expandedNodes, _a, type);
             _mcts->propagation(expandedNodes);
         }
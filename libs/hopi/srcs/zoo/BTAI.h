@@ -6,8 +6,10 @@
 #define EXPERIMENTS_AI_TS_BTAI_V2_H
 
 #include <memory>
+#include <string>
 #include <torch/torch.h>
 #include "algorithms/planning/EvaluationType.h"
+#include "memory/MemoryReport.h"
 
 namespace hopi::environments {
     class Environment;
@@ -22,6 +24,9 @@ namespace hopi::algorithms::planning {
 namespace hopi::nodes {
     class VarNode;
 }
+namespace hopi::zoo {
+    class BTAIConfig;
+}
 
 namespace hopi::zoo {
 
@@ -35,12 +40,15 @@ namespace hopi::zoo {
          * @param env the environment.
          * @param config the configuration of the tree search.
          * @param obs the initial observation.
+         * @param inference_config the configuration of the inference performed before planning, nullptr for the
+         * default configuration (see BTAIConfig::create).
          * @return the BTAI agent.
          */
         static std::shared_ptr<BTAI> create(
             const environments::Environment *env,
             const std::shared_ptr<algorithms::planning::MCTSConfig> &config,
-            const torch::Tensor &obs
+            const torch::Tensor &obs,
+            const std::shared_ptr<BTAIConfig> &inference_config = nullptr
         );
 
         /**
@@ -48,11 +56,47 @@ namespace hopi::zoo {
          * @param env the environment.
          * @param config the configuration of the tree search.
          * @param obs the initial observation.
+         * @param inference_config the configuration of the inference performed before planning, nullptr for the
+         * default configuration (see BTAIConfig::create).
          */
         BTAI(
             const environments::Environment *env,
             const std::shared_ptr<algorithms::planning::MCTSConfig> &config,
-            const torch::Tensor &obs
+            const torch::Tensor &obs,
+            const std::shared_ptr<BTAIConfig> &inference_config = nullptr
+        );
+
+        /**
+         * Create a BTAI agent from an existing factor graph, e.g., a graph restored from a checkpoint.
+         * @param fg the factor graph of the agent, whose tree root must be set.
+         * @param a the likelihood mapping.
+         * @param b the transition mapping.
+         * @param d the prior over initial states.
+         * @param config the configuration of the tree search.
+         * @param inference_config the configuration of the inference performed before planning, nullptr for the
+         * default configuration (see BTAIConfig::create).
+         */
+        BTAI(
+            const std::shared_ptr<graphs::FactorGraph> &fg,
+            const torch::Tensor &a,
+            const torch::Tensor &b,
+            const torch::Tensor &d,
+            const std::shared_ptr<algorithms::planning::MCTSConfig> &config,
+            const std::shared_ptr<BTAIConfig> &inference_config = nullptr
+        );
+
+        /**
+         * Load a BTAI agent from a checkpoint.
+         * @param file_name the name of the checkpoint file.
+         * @param config the configuration of the tree search.
+         * @param inference_config the configuration of the inference performed before planning, nullptr for the
+         * default configuration (see BTAIConfig::create).
+         * @return the BTAI agent.
+         */
+        static std::shared_ptr<BTAI> load(
+            const std::string &file_name,
+            const std::shared_ptr<algorithms::planning::MCTSConfig> &config,
+            const std::shared_ptr<BTAIConfig> &inference_config = nullptr
         );
 
         /**
@@ -61,7 +105,20 @@ namespace hopi::zoo {
         ~BTAI();
 
         /**
-         * Execute on step of the action perception cycle in the environment.
+         * Save the agent in a checkpoint, i.e., its factor graph and its model.
+         * @param file_name the name of the checkpoint file.
+         */
+        void save(const std::string &file_name);
+
+        /**
+         * Compute the memory used by the agent, i.e., by its factor graph, its planner and its model.
+         * @return the memory report
+         */
+        [[nodiscard]] memory::MemoryReport memory() const;
+
+        /**
+         * Execute on step of the action perception cycle in the environment. The posteriors are first updated as
+         * requested by the inference configuration, then the tree search is performed.
          * @param env the environment to act in.
          * @param type the type of evaluation to use during planning.
          */
@@ -75,6 +132,7 @@ namespace hopi::zoo {
         torch::Tensor _b;
         torch::Tensor _d;
 
+        std::shared_ptr<BTAIConfig> _config;
         std::unique_ptr<algorithms::planning::MCTS> _mcts;
         std::shared_ptr<graphs::FactorGraph> _fg;
     };
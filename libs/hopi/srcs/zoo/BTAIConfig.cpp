@@ -0,0 +1,50 @@
+#include "BTAIConfig.h"
+
+using namespace hopi::algorithms::inference;
+
+namespace hopi::zoo {
+
+    std::shared_ptr<BTAIConfig> BTAIConfig::create(ScheduleType schedule, double epsilon, bool smoothing) {
+        return std::make_shared<BTAIConfig>(schedule, epsilon, smoothing);
+    }
+
+    BTAIConfig::BTAIConfig(ScheduleType schedule, double epsilon, bool smoothing) {
+        _schedule = schedule;
+        _epsilon = epsilon;
+        _smoothing = smoothing;
+    }
+
+    ScheduleType BTAIConfig::schedule() const {
+        return _schedule;
+    }
+
+    double BTAIConfig::epsilon() const {
+        return _epsilon;
+    }
+
+    bool BTAIConfig::smoothing() const {
+        return _smoothing;
+    }
+
+    void BTAIConfig::setSchedule(ScheduleType value) {
+        _schedule = value;
+    }
+
+    void BTAIConfig::setEpsilon(double value) {
+        _epsilon = value;
+    }
+
+    void BTAIConfig::setSmoothing(bool value) {
+        _smoothing = value;
+    }
+
+    void BTAIConfig::print(std::ostream &output) const {
+        static const char *schedules[] = {"sweep", "residual", "parallel"};
+        output << "========== BTAI CONFIGURATION ==========" << std::endl;
+        output << "Inference schedule: " << schedules[_schedule] << std::endl;
+        output << "Convergence threshold: " << _epsilon << std::endl;
+        output << "Forward-backward smoothing: " << (_smoothing ? "yes" : "no") << std::endl;
+        output << std::endl;
+    }
+
+}
@@ -0,0 +1,90 @@
+#ifndef HOMING_PIGEON_BTAI_CONFIG_H
+#define HOMING_PIGEON_BTAI_CONFIG_H
+
+#include <memory>
+#include <ostream>
+#include "algorithms/inference/ScheduleType.h"
+
+namespace hopi::zoo {
+
+    /**
+     * A class storing the configuration of the inference performed by the BTAI agent before planning.
+     */
+    class BTAIConfig {
+    public:
+        /**
+         * Create a configuration for the inference of the BTAI agent.
+         * @param schedule the schedule of the VMP updates. RESIDUAL (the default) only re-infers the nodes around
+         * those added since the last step, and stops when no posterior changes by more than epsilon. SWEEP and
+         * PARALLEL update all the hidden variables of the graph until the VFE decreases by less than epsilon.
+         * @param epsilon the convergence threshold, on the residuals for RESIDUAL, and on the VFE otherwise.
+         * @param smoothing whether the exact forward-backward algorithm is used instead of VMP when the graph is a
+         * chain. Its cost is linear in the length of the chain at every step, but it computes the exact smoothed
+         * posteriors of all the slices.
+         * @return the configuration.
+         */
+        static std::shared_ptr<BTAIConfig> create(
+                algorithms::inference::ScheduleType schedule = algorithms::inference::RESIDUAL,
+                double epsilon = 0.01,
+                bool smoothing = false
+        );
+
+        /**
+         * Constructor.
+         * @param schedule the schedule of the VMP updates.
+         * @param epsilon the convergence threshold.
+         * @param smoothing whether the exact forward-backward algorithm is used when the graph is a chain.
+         */
+        BTAIConfig(algorithms::inference::ScheduleType schedule, double epsilon, bool smoothing);
+
+        /**
+         * Getter.
+         * @return the schedule of the VMP updates.
+         */
+        [[nodiscard]] algorithms::inference::ScheduleType schedule() const;
+
+        /**
+         * Getter.
+         * @return the convergence threshold.
+         */
+        [[nodiscard]] double epsilon() const;
+
+        /**
+         * Getter.
+         * @return whether the exact forward-backward algorithm is used when the graph is a chain.
+         */
+        [[nodiscard]] bool smoothing() const;
+
+        /**
+         * Setter.
+         * @param value new schedule of the VMP updates.
+         */
+        void setSchedule(algorithms::inference::ScheduleType value);
+
+        /**
+         * Setter.
+         * @param value new convergence threshold.
+         */
+        void setEpsilon(double value);
+
+        /**
+         * Setter.
+         * @param value whether the exact forward-backward algorithm is used when the graph is a chain.
+         */
+        void setSmoothing(bool value);
+
+        /**
+         * Print the configuration in the output stream.
+         * @param output the stream
+         */
+        void print(std::ostream &output) const;
+
+    private:
+        algorithms::inference::ScheduleType _schedule;
+        double _epsilon;
+        bool _smoothing;
+    };
+
+}
+
+#endif //HOMING_PIGEON_BTAI_CONFIG_H
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+#include "algorithms/inference/ForwardBackward.h"
+#include "algorithms/planning/MCTS.h"
+#include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Categorical.h"
+#include "helpers/UnitTests.h"
+#include "math/Ops.h"
+#include "api/API.h"
+
+using namespace torch;
+using namespace hopi::algorithms::inference;
+using namespace hopi::algorithms::planning;
+using namespace hopi::distributions;
+using namespace hopi::graphs;
+using namespace hopi::api;
+using namespace hopi::nodes;
+using namespace hopi::math;
+using namespace tests;
+
+/**
+ * Create a chain of three time steps, similar to the ones built by FactorGraph::integrate.
+ * @param A the likelihood mapping
+ * @param B the transition mapping
+ * @return the hidden states and the actions
+ */
+static std::vector<VarNode*> createChain(const Tensor &A, const Tensor &B) {
+    FactorGraph::setCurrent(nullptr);
+    auto fg = FactorGraph::current();
+    VarNode *s0 = API::Categorical(torch::tensor({0.6, 0.3, 0.1}));
+    VarNode *o0 = API::Transition(s0, A);
+    o0->setType(OBSERVED);
+    o0->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+    fg->setTreeRoot(s0);
+    fg->integrate(1, Ops::one_hot(2, 1), A, B);
+    fg->integrate(0, Ops::one_hot(2, 1), A, B);
+
+    auto s1 = fg->treeRoot()->parent()->parent(0);
+    return {s0, s1, fg->treeRoot(), s1->parent()->parent(1), fg->treeRoot()->parent()->parent(1)};
+}
+
+TEST_CASE( "ForwardBackward.inference() computes the exact posteriors of a chain" ) {
+    UnitTests::run([](){
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 5, 0);
+        auto vars = createChain(A, B);
+        REQUIRE( ForwardBackward::inference(FactorGraph::current()) );
+
+        // Compute the exact marginals by enumerating all the states and actions
+        Tensor D  = vars[0]->prior()->params();
+        Tensor U0 = vars[3]->prior()->params();
+        Tensor U1 = vars[4]->prior()->params();
+        std::vector<Tensor> marginals = {
+            API::zeros({3}), API::zeros({3}), API::zeros({3}),
+            API::zeros({2}), API::zeros({2})
+        };
+        for (int s0 = 0; s0 < 3; ++s0)
+        for (int s1 = 0; s1 < 3; ++s1)
+        for (int s2 = 0; s2 < 3; ++s2)
+        for (int a0 = 0; a0 < 2; ++a0)
+        for (int a1 = 0; a1 < 2; ++a1) {
+            double p = D[s0].item<double>() * A[0][s0].item<double>()
+                     * U0[a0].item<double>() * B[s1][s0][a0].item<double>() * A[1][s1].item<double>()
+                     * U1[a1].item<double>() * B[s2][s1][a1].item<double>() * A[1][s2].item<double>();
+            marginals[0][s0] += p;
+            marginals[1][s1] += p;
+            marginals[2][s2] += p;
+            marginals[3][a0] += p;
+            marginals[4][a1] += p;
+        }
+        for (int i = 0; i < vars.size(); ++i) {
+            Tensor expected = marginals[i] / marginals[i].sum();
+            REQUIRE( torch::allclose(vars[i]->posterior()->params(), expected) );
+        }
+        REQUIRE( FactorGraph::current()->dirtyNodes().empty() );
+    });
+}
+
+TEST_CASE( "ForwardBackward.isChain() returns false when the graph contains planning branches" ) {
+    UnitTests::run([](){
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = Ops::uniform({3,3,2});
+        auto vars = createChain(A, B);
+        MCTS::expansion(vars[2], A, B);
+        REQUIRE( !ForwardBackward::isChain(FactorGraph::current()) );
+
+        // The inference leaves the graph untouched, so that the caller can fall back on VMP
+        auto dirty = FactorGraph::current()->dirtyNodes().size();
+        REQUIRE( !ForwardBackward::inference(FactorGraph::current()) );
+        REQUIRE( FactorGraph::current()->dirtyNodes().size() == dirty );
+    });
+}
+
+TEST_CASE( "ForwardBackward.isChain() returns false when the graph contains Dirichlet priors" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        VarNode *D = API::Dirichlet(torch::ones({3}));
+        VarNode *s0 = API::Categorical(D);
+        VarNode *o0 = API::Transition(s0, Ops::uniform({2,3}));
+        o0->setType(OBSERVED);
+        REQUIRE( !ForwardBackward::isChain(FactorGraph::current()) );
+    });
+}
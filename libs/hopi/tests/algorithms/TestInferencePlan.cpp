@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include "algorithms/inference/InferencePlan.h"
+#include "algorithms/inference/VMP.h"
+#include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "distributions/Categorical.h"
+#include "helpers/UnitTests.h"
+#include "math/Ops.h"
+#include "api/API.h"
+#include <stdexcept>
+
+using namespace torch;
+using namespace hopi::algorithms::inference;
+using namespace hopi::distributions;
+using namespace hopi::graphs;
+using namespace hopi::api;
+using namespace hopi::nodes;
+using namespace hopi::math;
+using namespace tests;
+
+/**
+ * Create a graph with two time steps and non-uniform parameters.
+ * @return the hidden states and action of the graph
+ */
+static std::vector<VarNode*> createGraph() {
+    FactorGraph::setCurrent(nullptr);
+    Tensor D = torch::tensor({0.7, 0.2, 0.1});
+    Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+    Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 10, 0);
+    VarNode *a0 = API::Categorical(torch::tensor({0.3, 0.7}));
+    VarNode *s0 = API::Categorical(D);
+    VarNode *o0 = API::Transition(s0, A);
+    o0->setType(OBSERVED);
+    o0->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+    VarNode *s1 = API::ActiveTransition(s0, a0, B);
+    VarNode *o1 = API::Transition(s1, A);
+    o1->setType(OBSERVED);
+    o1->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+    return {a0, s0, s1};
+}
+
+TEST_CASE( "InferencePlan.run() computes the same posteriors and VFE as VMP.inference()" ) {
+    UnitTests::run([](){
+        auto vars = createGraph();
+        VMP::inference(FactorGraph::current()->getNodes(), 0.0000001);
+        double F = VMP::vfe(FactorGraph::current()->getNodes());
+        std::vector<Tensor> expected;
+        for (auto var : vars) {
+            expected.push_back(var->posterior()->params());
+        }
+
+        vars = createGraph();
+        auto plan = InferencePlan::create(FactorGraph::current());
+        plan->run(0.0000001);
+        for (int i = 0; i < vars.size(); ++i) {
+            REQUIRE( torch::allclose(expected[i], vars[i]->posterior()->params(), 0, 0.0001) );
+        }
+        REQUIRE( plan->vfe() == Approx(F).margin(0.0001) );
+        REQUIRE( VMP::vfe(FactorGraph::current()->getNodes()) == Approx(F).margin(0.0001) );
+    });
+}
+
+TEST_CASE( "InferencePlan is compiled again when the graph's structure changes" ) {
+    UnitTests::run([](){
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        auto vars = createGraph();
+        VarNode *o2 = API::Transition(vars[2], A);
+        VMP::inference(FactorGraph::current()->getNodes(), 0.0000001);
+        Tensor expected = o2->posterior()->params();
+
+        vars = createGraph();
+        auto plan = InferencePlan::create(FactorGraph::current());
+        REQUIRE( !plan->outdated() );
+        o2 = API::Transition(vars[2], A);
+        REQUIRE( plan->outdated() );
+        plan->run(0.0000001);
+        REQUIRE( !plan->outdated() );
+        REQUIRE( torch::allclose(expected, o2->posterior()->params(), 0, 0.0001) );
+    });
+}
+
+TEST_CASE( "InferencePlan is outdated when the type of a variable changes" ) {
+    UnitTests::run([](){
+        auto vars = createGraph();
+        auto plan = InferencePlan::create(FactorGraph::current());
+
+        vars[2]->setType(HIDDEN);
+        REQUIRE( !plan->outdated() );
+        vars[2]->setType(OBSERVED);
+        REQUIRE( plan->outdated() );
+        plan->run();
+        REQUIRE( !plan->outdated() );
+
+        plan = InferencePlan::create(FactorGraph::current());
+        REQUIRE( !plan->outdated() );
+        vars[2]->setType(HIDDEN);
+        REQUIRE( plan->outdated() );
+    });
+}
+
+TEST_CASE( "InferencePlan does not support graphs with Dirichlet priors" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        VarNode *D = API::Dirichlet(torch::ones({3}));
+        API::Categorical(D);
+        REQUIRE_THROWS_AS( InferencePlan::create(FactorGraph::current()), std::runtime_error );
+    });
+}
@@ -233,3 +233,20 @@ TEST_CASE( "Action selection returns the child variable with the lowest average
         REQUIRE(algo.selectAction(root) == c0->data()->action );
     });
 }
+
+TEST_CASE( "Prediction computes the beliefs of the expanded nodes in one forward pass." ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 10, 0);
+        fg->treeRoot()->setPosterior(Categorical::create(torch::tensor({0.5, 0.3, 0.2})));
+
+        auto nodes = MCTS::expansion(fg->treeRoot(), A, B);
+        MCTS::prediction(nodes);
+        for (int action = 0; action < 2; ++action) {
+            Tensor s = matmul(squeeze(torch::narrow(B, 2, action, 1)), fg->treeRoot()->posterior()->params());
+            REQUIRE( torch::allclose(nodes[2 * action]->posterior()->params(), s) );
+            REQUIRE( torch::allclose(nodes[2 * action + 1]->posterior()->params(), matmul(A, s)) );
+        }
+    });
+}
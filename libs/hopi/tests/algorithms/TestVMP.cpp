@@ -4,6 +4,8 @@
 
 #include "catch.hpp"
 #include "algorithms/inference/VMP.h"
+#include "algorithms/inference/VMPConfig.h"
+#include "algorithms/inference/VMPStats.h"
 #include "graphs/FactorGraph.h"
 #include "math/Ops.h"
 #include "contexts/FactorGraphContexts.h"
@@ -12,7 +14,11 @@
 #include "distributions/Categorical.h"
 #include "helpers/UnitTests.h"
 #include "api/API.h"
+#include "iterators/AdjacentFactorsIter.h"
+#include "iterators/HiddenVarIter.h"
 #include <iostream>
+#include <thread>
+#include <atomic>
 
 using namespace torch;
 using namespace hopi::algorithms::inference;
@@ -21,6 +27,7 @@ using namespace hopi::graphs;
 using namespace hopi::api;
 using namespace hopi::nodes;
 using namespace hopi::math;
+using namespace hopi::iterators;
 using namespace tests;
 
 TEST_CASE( "Inference process stop when vfe has converged (according to epsilon)" ) {
@@ -72,3 +79,302 @@ TEST_CASE( "VMP.vfe() returns the variational free energy of the variables sent
         REQUIRE( F == Approx(res).epsilon(0.1) );
     });
 }
+
+TEST_CASE( "VMP.inference() with a residual schedule converges to the same posteriors as the sweep schedule" ) {
+    UnitTests::run([](){
+        Tensor D = torch::tensor({0.7, 0.2, 0.1});
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::tensor({{0.6, 0.3, 0.1}, {0.3, 0.5, 0.2}, {0.1, 0.2, 0.7}});
+        Tensor posteriors[2][2];
+
+        for (int i = 0; i < 2; ++i) {
+            FactorGraph::setCurrent(nullptr);
+            auto fg = FactorGraph::current();
+            VarNode *s0 = API::Categorical(D);
+            VarNode *o0 = API::Transition(s0, A);
+            VarNode *s1 = API::Transition(s0, B);
+            VarNode *o1 = API::Transition(s1, A);
+            o0->setType(OBSERVED);
+            o0->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+            o1->setType(OBSERVED);
+            o1->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+
+            if (i == 0) {
+                VMP::inference(fg->getNodes(), SWEEP, 0.00001);
+            } else {
+                VMP::inference(fg->getNodes(), RESIDUAL, 0.00001);
+            }
+            posteriors[i][0] = s0->posterior()->params();
+            posteriors[i][1] = s1->posterior()->params();
+        }
+        REQUIRE( torch::allclose(posteriors[0][0], posteriors[1][0], 0, 0.001) );
+        REQUIRE( torch::allclose(posteriors[0][1], posteriors[1][1], 0, 0.001) );
+    });
+}
+
+TEST_CASE( "VMP.incrementalInference() only re-infers the part of the graph marked as dirty" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        auto fg = FactorGraph::current();
+        Tensor A = torch::tensor({{0.8, 0.1}, {0.2, 0.9}});
+        Tensor B = torch::tensor({{0.9, 0.1}, {0.1, 0.9}});
+        VarNode *s0 = API::Categorical(Ops::uniform({2}));
+        VarNode *o0 = API::Transition(s0, A);
+        o0->setType(OBSERVED);
+        o0->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+        REQUIRE( fg->dirtyNodes().size() == 2 );
+
+        VMP::incrementalInference(fg, 0.00001);
+        REQUIRE( fg->dirtyNodes().empty() );
+
+        VarNode *s1 = API::Transition(s0, B);
+        VarNode *o1 = API::Transition(s1, A);
+        o1->setType(OBSERVED);
+        o1->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+        REQUIRE( fg->dirtyNodes().size() == 2 );
+
+        VMP::incrementalInference(fg, 0.00001);
+        Tensor p0 = s0->posterior()->params();
+        Tensor p1 = s1->posterior()->params();
+        VMP::inference(fg->getNodes(), 0.00001);
+        REQUIRE( torch::allclose(p0, s0->posterior()->params(), 0, 0.001) );
+        REQUIRE( torch::allclose(p1, s1->posterior()->params(), 0, 0.001) );
+    });
+}
+
+TEST_CASE( "VMP.colour() never gives the same colour to two variables sharing a factor" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto classes = VMP::colour(fg->getNodes());
+
+        size_t n = 0;
+        for (auto &colourClass : classes) {
+            n += colourClass.size();
+            for (auto var : colourClass) {
+                for (AdjacentFactorsIter it(var); *it != nullptr; ++it) {
+                    for (auto neighbour : (*it)->neighbours()) {
+                        if (neighbour != var) {
+                            REQUIRE( std::find(colourClass.begin(), colourClass.end(), neighbour) == colourClass.end() );
+                        }
+                    }
+                }
+            }
+        }
+        REQUIRE( n == fg->nHiddenVar() );
+    });
+}
+
+TEST_CASE( "VMP.inference() with a parallel schedule converges to the same posteriors as the sweep schedule" ) {
+    UnitTests::run([](){
+        Tensor posteriors[2][3];
+
+        VMP::setNumberOfThreads(4);
+        for (int i = 0; i < 2; ++i) {
+            auto fg = FactorGraphContexts::context2();
+            auto vars = fg->getNodes();
+            VMP::inference(vars, (i == 0) ? SWEEP : PARALLEL, 0.00001);
+            HiddenVarIter it(vars);
+            for (int j = 0; j < 3 && *it != nullptr; ++j, ++it) {
+                posteriors[i][j] = (*it)->posterior()->params();
+            }
+        }
+        for (int j = 0; j < 3; ++j) {
+            if (posteriors[0][j].defined()) {
+                REQUIRE( torch::allclose(posteriors[0][j], posteriors[1][j], 0, 0.001) );
+            }
+        }
+    });
+}
+
+TEST_CASE( "VMP.setNumberOfThreads() can be called while a parallel inference is running" ) {
+    UnitTests::run([](){
+        std::atomic<bool> done = false;
+        std::thread resizer([&done](){
+            for (int n = 1; !done; n = n % 4 + 1) {
+                VMP::setNumberOfThreads(n);
+            }
+        });
+        for (int i = 0; i < 20; ++i) {
+            auto fg = FactorGraphContexts::context2();
+            VMP::inference(fg->getNodes(), PARALLEL, 0.00001);
+        }
+        done = true;
+        resizer.join();
+    });
+}
+
+TEST_CASE( "VMP.inference() on a batched graph gives the same posteriors as one graph per agent" ) {
+    UnitTests::run([](){
+        Tensor D = torch::tensor({0.7, 0.2, 0.1});
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 10, 0);
+        Tensor U = torch::tensor({{0.9, 0.1}, {0.2, 0.8}});
+        Tensor obs = torch::tensor({{1.0, 0.0}, {0.0, 1.0}});
+
+        // Create the batched graph
+        FactorGraph::setCurrent(nullptr);
+        auto fg = FactorGraph::current();
+        fg->setBatchSize(2);
+        VarNode *a0 = API::Categorical(U);
+        VarNode *s0 = API::Categorical(D);
+        VarNode *s1 = API::ActiveTransition(s0, a0, B);
+        VarNode *o1 = API::Transition(s1, A);
+        o1->setType(OBSERVED);
+        o1->setPosterior(Categorical::create(obs));
+        VMP::inference(fg->getNodes(), 0.0000001);
+        Tensor batched[3] = {a0->posterior()->params(), s0->posterior()->params(), s1->posterior()->params()};
+        REQUIRE( batched[1].sizes() == IntArrayRef({2,3}) );
+
+        // Create one graph per agent
+        for (int i = 0; i < 2; ++i) {
+            FactorGraph::setCurrent(nullptr);
+            fg = FactorGraph::current();
+            a0 = API::Categorical(U[i]);
+            s0 = API::Categorical(D);
+            s1 = API::ActiveTransition(s0, a0, B);
+            o1 = API::Transition(s1, A);
+            o1->setType(OBSERVED);
+            o1->setPosterior(Categorical::create(obs[i]));
+            VMP::inference(fg->getNodes(), 0.0000001);
+            REQUIRE( torch::allclose(batched[0][i], a0->posterior()->params(), 0, 0.0001) );
+            REQUIRE( torch::allclose(batched[1][i], s0->posterior()->params(), 0, 0.0001) );
+            REQUIRE( torch::allclose(batched[2][i], s1->posterior()->params(), 0, 0.0001) );
+        }
+    });
+}
+
+TEST_CASE( "VMP.inference() with the default configuration performs the standard updates and records telemetry" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto vars = fg->getNodes();
+        VMP::inference(vars, 0.0001);
+        double F = VMP::vfe(vars);
+
+        fg = FactorGraphContexts::context2();
+        vars = fg->getNodes();
+        VMPStats stats;
+        VMP::inference(vars, VMPConfig::create(0.0001), &stats);
+        REQUIRE( VMP::vfe(vars) == F );
+        REQUIRE( stats.nbSweeps() > 0 );
+        REQUIRE( stats.vfe(stats.nbSweeps() - 1) == F );
+        REQUIRE( stats.totalUpdates() == stats.nbSweeps() * fg->nHiddenVar() );
+        REQUIRE( stats.totalSkipped() == 0 );
+    });
+}
+
+TEST_CASE( "VMP.inference() with relaxation and per-node tolerance converges to the standard posteriors" ) {
+    UnitTests::run([](){
+        Tensor D = torch::tensor({0.7, 0.2, 0.1});
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::tensor({{0.6, 0.3, 0.1}, {0.3, 0.5, 0.2}, {0.1, 0.2, 0.7}});
+        Tensor posteriors[2];
+
+        for (int i = 0; i < 2; ++i) {
+            FactorGraph::setCurrent(nullptr);
+            auto fg = FactorGraph::current();
+            VarNode *s0 = API::Categorical(D);
+            VarNode *o0 = API::Transition(s0, A);
+            VarNode *s1 = API::Transition(s0, B);
+            VarNode *o1 = API::Transition(s1, A);
+            API::Transition(s1, B);
+            o0->setType(OBSERVED);
+            o0->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+            o1->setType(OBSERVED);
+            o1->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+
+            VMPStats stats;
+            auto config = VMPConfig::create(0.0000001);
+            if (i == 1) {
+                config->setRelaxation(1.2);
+                config->setNodeTolerance(0.00001);
+            }
+            VMP::inference(fg->getNodes(), config, &stats);
+            posteriors[i] = s0->posterior()->params();
+            REQUIRE( stats.nbSweeps() > 0 );
+        }
+        REQUIRE( torch::allclose(posteriors[0], posteriors[1], 0, 0.001) );
+    });
+}
+
+TEST_CASE( "VMP.inference() reaches the standard posteriors when the over-relaxed updates increase the VFE" ) {
+    UnitTests::run([](){
+        Tensor D = torch::tensor({0.7, 0.2, 0.1});
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::tensor({{0.6, 0.3, 0.1}, {0.3, 0.5, 0.2}, {0.1, 0.2, 0.7}});
+        Tensor posteriors[2][2];
+
+        for (int i = 0; i < 2; ++i) {
+            FactorGraph::setCurrent(nullptr);
+            auto fg = FactorGraph::current();
+            VarNode *s0 = API::Categorical(D);
+            VarNode *o0 = API::Transition(s0, A);
+            VarNode *s1 = API::Transition(s0, B);
+            VarNode *o1 = API::Transition(s1, A);
+            API::Transition(s1, B);
+            o0->setType(OBSERVED);
+            o0->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+            o1->setType(OBSERVED);
+            o1->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+
+            VMPStats stats;
+            auto config = VMPConfig::create(0.0000001);
+            config->setRelaxation(i == 0 ? 1.0 : 1.9);
+            VMP::inference(fg->getNodes(), config, &stats);
+            posteriors[i][0] = s0->posterior()->params();
+            posteriors[i][1] = s1->posterior()->params();
+
+            // With such a large relaxation factor, the second sweep increases the VFE
+            bool increased = false;
+            for (int j = 1; j < stats.nbSweeps(); ++j) {
+                increased = increased || stats.vfe(j) > stats.vfe(j - 1) + 0.001;
+            }
+            REQUIRE( increased == (i == 1) );
+        }
+        for (int j = 0; j < 2; ++j) {
+            REQUIRE( torch::allclose(posteriors[0][j], posteriors[1][j], 0, 0.001) );
+        }
+    });
+}
+
+TEST_CASE( "VMP.inference() with relaxation keeps the Dirichlet posteriors of learned parameters as counts" ) {
+    UnitTests::run([](){
+        Tensor D = torch::tensor({0.7, 0.2, 0.1});
+        Tensor theta_A = torch::tensor({{2.0, 1.0}, {1.0, 3.0}, {1.5, 1.5}});
+        Tensor theta_B = torch::tensor({{3.0, 1.0, 1.0}, {1.0, 3.0, 1.0}, {1.0, 1.0, 3.0}});
+        Tensor posteriors[2][3];
+
+        for (int i = 0; i < 2; ++i) {
+            FactorGraph::setCurrent(nullptr);
+            auto fg = FactorGraph::current();
+            VarNode *A = API::Dirichlet(theta_A);
+            VarNode *B = API::Dirichlet(theta_B);
+            VarNode *s0 = API::Categorical(D);
+            VarNode *o0 = API::Transition(s0, A);
+            VarNode *s1 = API::Transition(s0, B);
+            VarNode *o1 = API::Transition(s1, A);
+            o0->setType(OBSERVED);
+            o0->setPosterior(Categorical::create(Ops::one_hot(2, 1)));
+            o1->setType(OBSERVED);
+            o1->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+
+            auto config = VMPConfig::create(0.0000001);
+            config->setRelaxation(i == 0 ? 1.0 : 1.2);
+            VMP::inference(fg->getNodes(), config);
+
+            // Each observation adds one (expected) count to A, and the transition adds one count to B
+            Tensor A_counts = A->posterior()->params() - theta_A;
+            Tensor B_counts = B->posterior()->params() - theta_B;
+            REQUIRE( (A_counts >= -0.000001).all().item<bool>() );
+            REQUIRE( (B_counts >= -0.000001).all().item<bool>() );
+            REQUIRE( A_counts.sum().item<double>() == Approx(2.0) );
+            REQUIRE( B_counts.sum().item<double>() == Approx(1.0) );
+
+            posteriors[i][0] = A->posterior()->params();
+            posteriors[i][1] = B->posterior()->params();
+            posteriors[i][2] = s0->posterior()->params();
+        }
+        for (int j = 0; j < 3; ++j) {
+            REQUIRE( torch::allclose(posteriors[0][j], posteriors[1][j], 0, 0.01) );
+        }
+    });
+}
@@ -0,0 +1,34 @@
+#include "catch.hpp"
+#include "concurrency/ThreadPool.h"
+#include "helpers/UnitTests.h"
+#include <atomic>
+#include <stdexcept>
+
+using namespace hopi::concurrency;
+using namespace tests;
+
+TEST_CASE( "ThreadPool.run() executes all the tasks before returning" ) {
+    UnitTests::run([](){
+        for (int nThreads = 0; nThreads < 4; ++nThreads) {
+            auto pool = ThreadPool::create(nThreads);
+            std::atomic<int> counter(0);
+            std::vector<std::function<void()>> tasks;
+            for (int i = 0; i < 100; ++i) {
+                tasks.emplace_back([&counter](){ ++counter; });
+            }
+            pool->run(tasks);
+            REQUIRE( pool->size() == nThreads );
+            REQUIRE( counter == 100 );
+        }
+    });
+}
+
+TEST_CASE( "ThreadPool.run() re-throws the exceptions thrown by the tasks" ) {
+    UnitTests::run([](){
+        auto pool = ThreadPool::create(2);
+        std::vector<std::function<void()>> tasks;
+        tasks.emplace_back([](){ throw std::runtime_error("task failed"); });
+        tasks.emplace_back([](){});
+        REQUIRE_THROWS_AS( pool->run(tasks), std::runtime_error );
+    });
+}
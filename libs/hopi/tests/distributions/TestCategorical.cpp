@@ -79,3 +79,29 @@ TEST_CASE( "Categorical parameters update and getter work properly" ) {
         REQUIRE(equal(d.params(), softmax(param2, 0)));
     });
 }
+
+TEST_CASE( "Categorical distribution gets a new version when its parameters are updated" ) {
+    UnitTests::run([](){
+        auto c1 = Categorical::create(Ops::uniform({3}));
+        auto c2 = Categorical::create(Ops::uniform({3}));
+        REQUIRE( c1->version() != c2->version() );
+
+        long version = c1->version();
+        c1->updateParams(Ops::uniform({3}));
+        REQUIRE( c1->version() != version );
+        REQUIRE( c1->version() != c2->version() );
+    });
+}
+
+TEST_CASE( "Categorical parameters view shares the parameters' storage and is unaffected by updates" ) {
+    UnitTests::run([](){
+        auto d = Categorical::create(API::tensor({0.2,0.8}));
+        Tensor view = d->paramsView();
+        REQUIRE( view.data_ptr() == d->paramsView().data_ptr() );
+        REQUIRE( d->params().data_ptr() != view.data_ptr() );
+
+        d->updateParams(API::tensor({0.3,0.7}));
+        REQUIRE( equal(view, API::tensor({0.2,0.8})) );
+        REQUIRE( equal(d->paramsView(), softmax(API::tensor({0.3,0.7}), 0)) );
+    });
+}
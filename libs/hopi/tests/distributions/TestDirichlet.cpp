@@ -171,3 +171,14 @@ TEST_CASE( "Dirichlet::expectedLog() returns the proper results (3D)" ) {
         UnitTests::require_approximately_equal(output, result);
     });
 }
+
+TEST_CASE( "Dirichlet caches its expected log until its parameters are updated" ) {
+    UnitTests::run([](){
+        Dirichlet d = Dirichlet(API::tensor({{1,2},{3,4}}));
+        REQUIRE( d.expectedLog().data_ptr() == d.expectedLog().data_ptr() );
+        REQUIRE( equal(d.expectedLog(), Dirichlet::expectedLog(d.params())) );
+
+        d.updateParams(API::tensor({{5,6},{7,8}}));
+        REQUIRE( equal(d.expectedLog(), Dirichlet::expectedLog(API::tensor({{5,6},{7,8}}))) );
+    });
+}
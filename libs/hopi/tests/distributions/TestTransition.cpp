@@ -34,3 +34,16 @@ TEST_CASE( "Transition distribution returns the correct log params" ) {
         REQUIRE( equal(d2.logParams(),p2.log()) );
     });
 }
+
+TEST_CASE( "Transition distributions sharing their parameters share the cached log params" ) {
+    UnitTests::run([](){
+        Tensor p = API::tensor({{0.1,0.3},{0.9,0.7}});
+        Transition d1 = Transition(p);
+        Transition d2 = Transition(p);
+        Transition d3 = Transition(p.clone());
+        REQUIRE( equal(d1.logParams(), p.log()) );
+        REQUIRE( d1.logParams().data_ptr() == d1.logParams().data_ptr() );
+        REQUIRE( d1.logParams().data_ptr() == d2.logParams().data_ptr() );
+        REQUIRE( d1.logParams().data_ptr() != d3.logParams().data_ptr() );
+    });
+}
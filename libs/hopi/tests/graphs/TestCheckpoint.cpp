@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "graphs/Checkpoint.h"
+#include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Distribution.h"
+#include "algorithms/planning/MCTSNodeData.h"
+#include "contexts/FactorGraphContexts.h"
+#include "helpers/UnitTests.h"
+#include "math/Ops.h"
+#include "api/API.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <cstring>
+
+using namespace torch;
+using namespace hopi::graphs;
+using namespace hopi::nodes;
+using namespace hopi::math;
+using namespace hopi::api;
+using namespace tests;
+
+TEST_CASE( "Checkpoint.load restores the graph written by Checkpoint.save" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        fg->treeRoot()->setName("root");
+        fg->treeRoot()->data()->visits = 42;
+        fg->treeRoot()->data()->cost = 1.5;
+        Tensor A = Ops::uniform({2, 3});
+        std::string file_name = "checkpoint_test.hopi";
+
+        Checkpoint::save(file_name, fg.get(), {{"A", A}});
+        std::map<std::string, Tensor> extras;
+        auto loaded = Checkpoint::load(file_name, &extras);
+        std::remove(file_name.c_str());
+
+        REQUIRE( loaded->nodes() == fg->nodes() );
+        REQUIRE( loaded->factors() == fg->factors() );
+        REQUIRE( loaded->nObservedVar() == fg->nObservedVar() );
+        REQUIRE( loaded->treeRoot()->name() == "root" );
+        REQUIRE( loaded->treeRoot()->data()->visits == 42 );
+        REQUIRE( loaded->treeRoot()->data()->cost == 1.5 );
+        REQUIRE( loaded->nodesByName("root") == std::vector<VarNode*>{loaded->treeRoot()} );
+        REQUIRE( torch::equal(extras["A"], A) );
+        for (int i = 0; i < fg->nodes(); ++i) {
+            VarNode *expected = fg->node(i);
+            VarNode *var = loaded->node(i);
+            REQUIRE( var->type() == expected->type() );
+            REQUIRE( var->nChildren() == expected->nChildren() );
+            REQUIRE( var->parent()->type() == expected->parent()->type() );
+            REQUIRE( torch::equal(var->posterior()->params(), expected->posterior()->params()) );
+            if (expected->prior() != nullptr) {
+                REQUIRE( var->prior()->type() == expected->prior()->type() );
+                REQUIRE( torch::equal(var->prior()->params(), expected->prior()->params()) );
+            }
+        }
+        for (int i = 0; i < fg->factors(); ++i) {
+            REQUIRE( loaded->factor(i)->type() == fg->factor(i)->type() );
+        }
+    });
+}
+
+TEST_CASE( "Checkpoint.load rejects the files that are not checkpoints" ) {
+    UnitTests::run([](){
+        std::string file_name = "checkpoint_invalid.hopi";
+        std::ofstream file(file_name);
+        file << "This is not a checkpoint, but it is long enough to contain a header, i.e., more than 80 bytes.";
+        file.close();
+
+        REQUIRE_THROWS_AS( Checkpoint::load(file_name), std::runtime_error );
+        REQUIRE_THROWS_AS( Checkpoint::load("checkpoint_missing.hopi"), std::runtime_error );
+        std::remove(file_name.c_str());
+    });
+}
+
+/**
+ * Write bytes in a file.
+ * @param file_name the name of the file
+ * @param bytes the bytes to write
+ */
+static void writeBytes(const std::string &file_name, const std::vector<char> &bytes) {
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), (std::streamsize) bytes.size());
+}
+
+TEST_CASE( "Checkpoint.load rejects the truncated files and the corrupted records" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        fg->treeRoot()->setName("root");
+        std::string file_name = "checkpoint_corrupted.hopi";
+        Checkpoint::save(file_name, fg.get(), {{"A", Ops::uniform({2, 3})}});
+        std::ifstream file(file_name, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        // A truncated file
+        writeBytes(file_name, std::vector<char>(bytes.begin(), bytes.begin() + (long) bytes.size() / 2));
+        REQUIRE_THROWS_AS( Checkpoint::load(file_name), std::runtime_error );
+
+        // An invalid variable type, the table of variables directly follows the header
+        std::uint32_t header_size;
+        std::memcpy(&header_size, bytes.data() + 12, sizeof(header_size));
+        std::vector<char> corrupted = bytes;
+        std::int32_t value = 7;
+        std::memcpy(corrupted.data() + header_size, &value, sizeof(value));
+        writeBytes(file_name, corrupted);
+        REQUIRE_THROWS_AS( Checkpoint::load(file_name), std::runtime_error );
+
+        // Corrupt each word of the tables and of the blob in turn, the loading must either succeed or be rejected
+        int rejected = 0;
+        for (std::size_t i = header_size; i + sizeof(std::int32_t) <= bytes.size(); i += sizeof(std::int32_t)) {
+            for (std::int32_t v : {-1, -2, 2147483647}) {
+                corrupted = bytes;
+                std::memcpy(corrupted.data() + i, &v, sizeof(v));
+                writeBytes(file_name, corrupted);
+                try {
+                    std::map<std::string, Tensor> extras;
+                    Checkpoint::load(file_name, &extras);
+                } catch (const std::runtime_error &) {
+                    ++rejected;
+                }
+            }
+        }
+        REQUIRE( rejected > 0 );
+        std::remove(file_name.c_str());
+    });
+}
+
+TEST_CASE( "Checkpoint.save rejects the tensors with too many dimensions" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        std::string file_name = "checkpoint_dims.hopi";
+        Tensor t = torch::zeros(std::vector<std::int64_t>(Checkpoint::MAX_DIMS + 1, 1));
+        std::remove(file_name.c_str());
+
+        REQUIRE_THROWS_AS( Checkpoint::save(file_name, fg.get(), {{"T", t}}), std::runtime_error );
+        std::ifstream file(file_name);
+        REQUIRE( !file.is_open() );
+    });
+}
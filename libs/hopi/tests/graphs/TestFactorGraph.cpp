@@ -6,12 +6,16 @@
 #include "nodes/VarNode.h"
 #include "nodes/CategoricalNode.h"
 #include "graphs/FactorGraph.h"
+#include "graphs/GraphContext.h"
+#include "algorithms/inference/ForwardBackward.h"
 #include "distributions/Categorical.h"
 #include "helpers/Files.h"
 #include "math/Ops.h"
 #include "api/API.h"
 #include "contexts/FactorGraphContexts.h"
 #include <torch/torch.h>
+#include <thread>
+#include <atomic>
 #include "helpers/UnitTests.h"
 
 using namespace hopi::distributions;
@@ -19,6 +23,7 @@ using namespace hopi::graphs;
 using namespace hopi::nodes;
 using namespace hopi::math;
 using namespace hopi::api;
+using namespace hopi::algorithms::inference;
 using namespace tests;
 using namespace torch;
 
@@ -344,3 +349,231 @@ TEST_CASE( "FactorGraph.removeBranch properly cut off branches of the tree" ) {
         REQUIRE( root->lastChild() - root->firstChild() == 1 );
     });
 }
+
+TEST_CASE( "FactorGraph handles become stale when their node is removed, and recycled slots keep insertion order" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        Tensor B = Ops::uniform({3,3,2});
+        auto root = fg->treeRoot();
+
+        auto s0  = API::Transition(root, B[0]);
+        auto s00 = API::Transition(s0,   B[0]);
+        auto s1  = API::Transition(root, B[1]);
+        auto h0  = fg->handle(s00);
+        auto h1  = fg->handle(s1);
+        REQUIRE( fg->node(h0) == s00 );
+        REQUIRE( fg->node(h1) == s1 );
+
+        fg->removeBranch(s0->parent());
+        root->removeNullChildren();
+        REQUIRE( fg->node(h0) == nullptr );
+        REQUIRE( fg->node(h1) == s1 );
+        REQUIRE( fg->handle(s1).index == h1.index );
+        for (auto node : fg->dirtyNodes()) {
+            REQUIRE( node != s0 );
+            REQUIRE( node != s00 );
+        }
+
+        auto s2 = API::Transition(root, B[1]);
+        REQUIRE( fg->nodes() == 7 );
+        REQUIRE( fg->node(5) == s1 );
+        REQUIRE( fg->node(6) == s2 );
+        REQUIRE( fg->node(fg->handle(s2)) == s2 );
+    });
+}
+
+TEST_CASE( "FactorGraph keeps its indices of hidden, observed and named variables up to date" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        Tensor B = Ops::uniform({3,3,2});
+        auto root = fg->treeRoot();
+
+        REQUIRE( fg->nHiddenVar() == 3 );
+        REQUIRE( fg->nObservedVar() == 2 );
+        REQUIRE( fg->hiddenNodes().size() == 3 );
+        REQUIRE( fg->observedNodes().size() == 2 );
+
+        auto s0  = API::Transition(root, B[0]);
+        auto s00 = API::Transition(s0,   B[0]);
+        s0->setName("s0");
+        s00->setName("s00");
+        s00->setType(VarNodeType::OBSERVED);
+        REQUIRE( fg->nHiddenVar() == 4 );
+        REQUIRE( fg->nObservedVar() == 3 );
+        REQUIRE( fg->nodesByName("s0") == std::vector<VarNode*>{s0} );
+        REQUIRE( fg->nodesByName("s00") == std::vector<VarNode*>{s00} );
+
+        s0->setName("renamed");
+        REQUIRE( fg->nodesByName("s0").empty() );
+        REQUIRE( fg->nodesByName("renamed") == std::vector<VarNode*>{s0} );
+
+        fg->removeBranch(s0->parent());
+        root->removeNullChildren();
+        REQUIRE( fg->nHiddenVar() == 3 );
+        REQUIRE( fg->nObservedVar() == 2 );
+        REQUIRE( fg->nodesByName("renamed").empty() );
+        REQUIRE( fg->nodesByName("s00").empty() );
+        for (auto node : fg->observedNodes()) {
+            REQUIRE( node->type() == VarNodeType::OBSERVED );
+        }
+    });
+}
+
+TEST_CASE( "Each thread builds its model in its own current factor graph" ) {
+    UnitTests::run([](){
+        auto build = [](int n_states, std::shared_ptr<FactorGraph> *result) {
+            FactorGraph::setCurrent(nullptr);
+            API::setDataType(kDouble);
+            VarNode *s = API::Categorical(Ops::uniform({n_states}));
+            for (int i = 0; i < n_states; ++i) {
+                s = API::Transition(s, Ops::uniform({n_states, n_states}));
+            }
+            *result = FactorGraph::current();
+        };
+        std::shared_ptr<FactorGraph> fg1;
+        std::shared_ptr<FactorGraph> fg2;
+        std::thread t1(build, 3, &fg1);
+        std::thread t2(build, 5, &fg2);
+        t1.join();
+        t2.join();
+
+        REQUIRE( fg1 != fg2 );
+        REQUIRE( fg1->nodes() == 4 );
+        REQUIRE( fg2->nodes() == 6 );
+    });
+}
+
+TEST_CASE( "GraphContext changes the current factor graph within a scope" ) {
+    UnitTests::run([](){
+        auto fg1 = FactorGraphContexts::context2();
+        auto fg2 = std::make_shared<FactorGraph>();
+        {
+            GraphContext context(fg2);
+            REQUIRE( FactorGraph::current() == fg2 );
+            API::Categorical(Ops::uniform({3}));
+        }
+        REQUIRE( FactorGraph::current() == fg1 );
+        REQUIRE( fg1->nodes() == 5 );
+        REQUIRE( fg2->nodes() == 1 );
+    });
+}
+
+TEST_CASE( "FactorGraph.fork clones the tree's root and freezes the history" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto root = fg->treeRoot();
+        auto clone = fg->fork();
+        auto clone_root = clone->treeRoot();
+
+        REQUIRE( clone != fg );
+        REQUIRE( clone->nodes() == 2 );
+        REQUIRE( clone->factors() == 2 );
+        REQUIRE( clone->nHiddenVar() == 1 );
+        REQUIRE( clone_root != root );
+        REQUIRE( clone_root->graph() == clone.get() );
+        REQUIRE( clone_root->nChildren() == root->nChildren() );
+        REQUIRE( clone_root->parent()->type() == root->parent()->type() );
+        REQUIRE( equal(clone_root->posterior()->params(), root->posterior()->params()) );
+        REQUIRE( allclose(clone_root->parent()->message(clone_root), root->parent()->message(root)) );
+
+        // The previous state is frozen, i.e., it does not belong to the fork and its parent is a prior
+        VarNode *frozen = clone_root->parent()->parent(0);
+        REQUIRE( frozen != root->parent()->parent(0) );
+        REQUIRE( frozen->graph() == nullptr );
+        REQUIRE( frozen->parent()->parent(0) == nullptr );
+        REQUIRE( equal(frozen->prior()->params(), root->parent()->parent(0)->posterior()->params()) );
+
+        // Updating and expanding the clone leaves the original untouched
+        Tensor before = root->posterior()->params();
+        clone_root->posterior()->updateParams(torch::tensor({1.0, 2.0, 3.0}));
+        REQUIRE( equal(root->posterior()->params(), before) );
+        REQUIRE( !equal(clone_root->posterior()->params(), before) );
+
+        GraphContext context(clone);
+        API::Transition(clone_root, Ops::uniform({3, 3}));
+        REQUIRE( clone->nodes() == 3 );
+        REQUIRE( root->nChildren() == 1 );
+
+        // Updating the original leaves the clone untouched
+        Tensor frozen_before = frozen->posterior()->params();
+        root->parent()->parent(0)->posterior()->updateParams(torch::tensor({3.0, 2.0, 1.0}));
+        REQUIRE( equal(frozen->posterior()->params(), frozen_before) );
+    });
+}
+
+TEST_CASE( "FactorGraph.fork can be called while the original is updated" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto root = fg->treeRoot();
+        std::atomic<bool> done(false);
+        std::atomic<int> valid(0);
+
+        std::thread planner([&fg, &done, &valid](){
+            for (int i = 0; i < 100; ++i) {
+                auto clone = fg->fork();
+                Tensor beliefs = clone->treeRoot()->posterior()->params();
+                valid += (beliefs.size(0) == 3 && std::abs(beliefs.sum().item<double>() - 1) < 1e-6);
+            }
+            done = true;
+        });
+        for (int i = 0; !done; ++i) {
+            root->posterior()->updateParams(torch::tensor({1.0, 2.0, (double) (i % 10)}));
+        }
+        planner.join();
+        REQUIRE( valid == 100 );
+    });
+}
+
+/**
+ * Create a chain of time slices using FactorGraph::integrate.
+ * @param window_size the window size of the graph
+ * @param n_steps the number of slices to integrate
+ * @return the graph
+ */
+static std::shared_ptr<FactorGraph> createChain(int window_size, int n_steps) {
+    Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+    Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 5, 0);
+    FactorGraph::setCurrent(nullptr);
+    auto fg = FactorGraph::current();
+    fg->setWindowSize(window_size);
+    VarNode *s0 = API::Categorical(torch::tensor({0.6, 0.3, 0.1}));
+    VarNode *o0 = API::Transition(s0, A);
+    o0->setType(VarNodeType::OBSERVED);
+    o0->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+    fg->setTreeRoot(s0);
+    for (int i = 0; i < n_steps; ++i) {
+        fg->integrate(i % 2, Ops::one_hot(2, (i / 2) % 2), A, B);
+    }
+    return fg;
+}
+
+TEST_CASE( "FactorGraph.fork does not copy the history preceding the tree's root" ) {
+    UnitTests::run([](){
+        auto short_chain = createChain(0, 2);
+        auto long_chain = createChain(0, 8);
+        auto short_fork = short_chain->fork();
+        auto long_fork = long_chain->fork();
+
+        REQUIRE( long_chain->nodes() > short_chain->nodes() );
+        REQUIRE( short_fork->nodes() == 2 );
+        REQUIRE( long_fork->nodes() == 2 );
+        REQUIRE( long_fork->factors() == 2 );
+        REQUIRE( equal(long_fork->treeRoot()->posterior()->params(), long_chain->treeRoot()->posterior()->params()) );
+    });
+}
+
+TEST_CASE( "FactorGraph with a window size absorbs the oldest slices without changing the root's posterior" ) {
+    UnitTests::run([](){
+        auto full = createChain(0, 6);
+        REQUIRE( ForwardBackward::inference(full) );
+        Tensor expected = full->treeRoot()->posterior()->params();
+        REQUIRE( full->nodes() == 2 + 6 * 3 );
+
+        auto window = createChain(2, 6);
+        REQUIRE( window->nodes() == 2 + 1 * 3 );
+        REQUIRE( window->factors() == window->nodes() );
+        REQUIRE( window->nHiddenVar() == 3 );
+        REQUIRE( ForwardBackward::inference(window) );
+        REQUIRE( torch::allclose(window->treeRoot()->posterior()->params(), expected) );
+    });
+}
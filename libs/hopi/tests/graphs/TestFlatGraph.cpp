@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include "graphs/FlatGraph.h"
+#include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
+#include "nodes/FactorNode.h"
+#include "distributions/Categorical.h"
+#include "contexts/FactorGraphContexts.h"
+#include "helpers/UnitTests.h"
+#include "math/Ops.h"
+#include "api/API.h"
+
+using namespace torch;
+using namespace hopi::distributions;
+using namespace hopi::graphs;
+using namespace hopi::api;
+using namespace hopi::nodes;
+using namespace hopi::math;
+using namespace tests;
+
+TEST_CASE( "FlatGraph stores the structure of the factor graph in contiguous arrays" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto flat = FlatGraph::create(fg);
+
+        REQUIRE( flat->nVars() == fg->nodes() );
+        REQUIRE( flat->nFactors() == fg->factors() );
+        for (int i = 0; i < flat->nVars(); ++i) {
+            VarNode *var = flat->node(i);
+            REQUIRE( flat->handle(var) == i );
+            REQUIRE( flat->varType(i) == var->type() );
+            REQUIRE( flat->factor(flat->parent(i)) == var->parent() );
+            REQUIRE( flat->lastChild(i) - flat->firstChild(i) == var->nChildren() );
+            REQUIRE( torch::equal(flat->belief(i), var->posterior()->params()) );
+        }
+        for (int i = 0; i < flat->nFactors(); ++i) {
+            FactorNode *factor = flat->factor(i);
+            REQUIRE( flat->factorType(i) == factor->type() );
+            REQUIRE( flat->node(flat->child(i)) == factor->child() );
+            int j = 0;
+            for (auto it = flat->firstParent(i); it != flat->lastParent(i); ++it, ++j) {
+                REQUIRE( flat->node(*it) == factor->parent(j) );
+            }
+        }
+    });
+}
+
+TEST_CASE( "FlatGraph writes the beliefs of the hidden variables back into the graph" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto flat = FlatGraph::create(fg);
+        VarNode *root = fg->treeRoot();
+        int h = flat->handle(root);
+
+        std::vector<long> versions;
+        for (int i = 0; i < flat->nVars(); ++i) {
+            versions.push_back(flat->node(i)->posterior()->version());
+        }
+        Distribution *posterior = root->posterior();
+
+        flat->belief(h).copy_(torch::tensor({0.2, 0.3, 0.5}));
+        REQUIRE( !torch::allclose(root->posterior()->params(), flat->belief(h)) );
+        flat->store();
+        REQUIRE( root->posterior() == posterior );
+        REQUIRE( torch::allclose(root->posterior()->params(), flat->belief(h)) );
+        for (int i = 0; i < flat->nVars(); ++i) {
+            REQUIRE( (flat->node(i)->posterior()->version() == versions[i]) == (i != h) );
+        }
+        REQUIRE( flat->handle(nullptr) == -1 );
+    });
+}
+
+TEST_CASE( "FlatGraph skips the children disconnected by FactorGraph.removeBranch" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        Tensor B = Ops::uniform({3,3,2});
+        auto root = fg->treeRoot();
+        auto s0 = API::Transition(root, B[0]);
+        auto s1 = API::Transition(root, B[1]);
+
+        fg->removeBranch(s0->parent());
+        auto flat = FlatGraph::create(fg);
+        int h = flat->handle(root);
+
+        REQUIRE( flat->handle(s0) == -1 );
+        REQUIRE( flat->lastChild(h) - flat->firstChild(h) == 2 );
+        REQUIRE( flat->factor(*(flat->lastChild(h) - 1)) == s1->parent() );
+        for (int i = 0; i < flat->nFactors(); ++i) {
+            REQUIRE( flat->child(i) != -1 );
+            REQUIRE( flat->node(flat->child(i)) == flat->factor(i)->child() );
+        }
+    });
+}
+
+TEST_CASE( "FlatGraph stores the factors adjacent to a subset of the variables" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        Tensor B = Ops::uniform({3,3,2});
+        auto root = fg->treeRoot();
+        auto s0 = API::Transition(root, B[0]);
+        auto flat = FlatGraph::create(std::vector<VarNode*>{root});
+
+        REQUIRE( flat->nVars() == 1 );
+        REQUIRE( flat->nFactors() == 1 + root->nChildren() );
+        REQUIRE( flat->factor(flat->parent(0)) == root->parent() );
+        REQUIRE( flat->lastChild(0) - flat->firstChild(0) == root->nChildren() );
+        for (auto it = flat->firstChild(0); it != flat->lastChild(0); ++it) {
+            REQUIRE( flat->child(*it) == -1 );
+            REQUIRE( *flat->firstParent(*it) == 0 );
+        }
+        REQUIRE( flat->factor(*(flat->lastChild(0) - 1)) == s0->parent() );
+    });
+}
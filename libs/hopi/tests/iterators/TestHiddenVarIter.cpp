@@ -8,6 +8,7 @@
 #include "iterators/HiddenVarIter.h"
 #include "contexts/FactorGraphContexts.h"
 #include "graphs/FactorGraph.h"
+#include "nodes/VarNode.h"
 
 using namespace hopi::iterators;
 using namespace tests;
@@ -89,3 +90,17 @@ TEST_CASE( "HiddenVarIter properly support copy (=)" ) {
         REQUIRE( *it2 == nullptr );
     });
 }
+
+TEST_CASE( "HiddenVarIter can iterate over the index of hidden variables of a factor graph" ) {
+    UnitTests::run([](){
+        auto fg = FactorGraphContexts::context2();
+        auto it = HiddenVarIter(fg.get());
+
+        for (int i = 0; i < fg->nHiddenVar(); ++i) {
+            REQUIRE( *it != nullptr );
+            REQUIRE( (*it)->type() == hopi::nodes::VarNodeType::HIDDEN );
+            ++it;
+        }
+        REQUIRE( *it == nullptr );
+    });
+}
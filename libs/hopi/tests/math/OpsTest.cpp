@@ -48,6 +48,25 @@ TEST_CASE( "kl of non identical (Dirichlet) distributions is not zero." ) {
     });
 }
 
+TEST_CASE( "kl_dirichlet computes the KL divergences of many pairs of distributions at once" ) {
+    UnitTests::run([](){
+        auto d1 = Dirichlet::create(Ops::uniform({2}));
+        auto d2 = Dirichlet::create(API::tensor({0.1,0.9}));
+        auto d3 = Dirichlet::create(API::tensor({1.0,2.0,3.0,4.0,5.0,6.0}).view({2,3}));
+        auto d4 = Dirichlet::create(API::tensor({6.0,5.0,4.0,3.0,2.0,1.0}).view({2,3}));
+
+        auto kl = Ops::kl_dirichlet({d1.get(), d3.get(), d2.get()}, {d2.get(), d4.get(), d2.get()});
+        REQUIRE( kl.size() == 3 );
+        REQUIRE( kl[0] == Approx(1.1743590056) );
+        REQUIRE( kl[1] == Approx(6.2859390609) );
+        REQUIRE( kl[2] == Approx(0.0) );
+
+        Tensor rows = Ops::kl_dirichlet(d3->params(), d4->params());
+        REQUIRE( rows.dim() == 1 );
+        REQUIRE( rows.sum().item<double>() == Approx(kl[1]) );
+    });
+}
+
 TEST_CASE( "Beta function output correct values" ) {
     UnitTests::run([](){
         REQUIRE( Ops::beta(API::tensor({1.5,0.2}))  == Approx(4.477609374347168810412)  );
@@ -59,13 +78,13 @@ TEST_CASE( "Beta function output correct values" ) {
 TEST_CASE( "Logarithm of the beta function are correctly computed" ) {
     UnitTests::run([](){
         Tensor param1 = API::tensor({1.5,0.2});
-        REQUIRE( Ops::log_beta(param1) == log(Ops::beta(param1)) );
+        REQUIRE( Ops::log_beta(param1) == Approx(log(4.477609374347168810412)) );
 
         Tensor param2 = API::tensor({2,2});
-        REQUIRE( Ops::log_beta(param2) == log(Ops::beta(param2)) );
+        REQUIRE( Ops::log_beta(param2) == Approx(log(0.1666666666666666666667)) );
 
         Tensor param3 = API::tensor({0.01,3.5});
-        REQUIRE( Ops::log_beta(param3) == log(Ops::beta(param3)) );
+        REQUIRE( Ops::log_beta(param3) == Approx(log(98.34009340030244331049)) );
     });
 }
 
@@ -0,0 +1,88 @@
+#include "catch.hpp"
+#include "math/SpecialFunctions.h"
+#include "math/Ops.h"
+#include "api/API.h"
+#include "helpers/UnitTests.h"
+#include <torch/torch.h>
+#include <cmath>
+#include <vector>
+
+using namespace hopi::math;
+using namespace hopi::api;
+using namespace torch;
+using namespace tests;
+
+TEST_CASE( "SpecialFunctions computes the digamma and log gamma functions of scalars" ) {
+    UnitTests::run([](){
+        REQUIRE( SpecialFunctions::digamma(1)   == Approx(-0.5772156649015329).epsilon(1e-12) );
+        REQUIRE( SpecialFunctions::digamma(0.5) == Approx(-1.9635100260214235).epsilon(1e-12) );
+        REQUIRE( SpecialFunctions::digamma(100) == Approx(4.600161852738087).epsilon(1e-12)   );
+        REQUIRE( SpecialFunctions::lgamma(0.5)  == Approx(0.5723649429247001).epsilon(1e-12)  );
+        REQUIRE( SpecialFunctions::lgamma(1)    == Approx(0.0).margin(1e-12)                 );
+        REQUIRE( SpecialFunctions::lgamma(200)  == Approx(857.9336698258574).epsilon(1e-12)   );
+        REQUIRE( std::isnan(SpecialFunctions::digamma(0))  );
+        REQUIRE( std::isnan(SpecialFunctions::lgamma(-1.5)) );
+    });
+}
+
+TEST_CASE( "SpecialFunctions gives the same results with all the supported instruction sets" ) {
+    UnitTests::run([](){
+        // 13 elements, so that the arrays do not fill a whole number of vectors
+        std::vector<double> x = {0.001, 0.1, 0.5, 1, 1.5, 2, 3.7, 9.99, 10, 25.5, 100, 1000, 123456.7};
+        std::vector<float> x_f(x.begin(), x.end());
+
+        for (auto isa : {SCALAR, AVX2, AVX512}) {
+            if (!SpecialFunctions::supports(isa))
+                continue;
+            std::vector<double> digamma(x.size());
+            std::vector<double> lgamma(x.size());
+            std::vector<float> lgamma_f(x.size());
+            SpecialFunctions::digamma(x.data(), digamma.data(), x.size(), isa);
+            SpecialFunctions::lgamma(x.data(), lgamma.data(), x.size(), isa);
+            SpecialFunctions::lgamma(x_f.data(), lgamma_f.data(), x.size(), isa);
+            for (int i = 0; i < x.size(); ++i) {
+                REQUIRE( digamma[i] == Approx(SpecialFunctions::digamma(x[i])).epsilon(1e-12) );
+                REQUIRE( lgamma[i] == Approx(std::lgamma(x[i])).epsilon(1e-12).margin(1e-12) );
+                REQUIRE( lgamma_f[i] == Approx(std::lgamma(x_f[i])).epsilon(1e-6).margin(1e-6) );
+            }
+        }
+    });
+}
+
+TEST_CASE( "SpecialFunctions returns NaN for non-positive elements" ) {
+    UnitTests::run([](){
+        std::vector<double> x = {1, -1, 0, 2, -0.5, 3, 4, 5, -7};
+
+        for (auto isa : {SCALAR, AVX2, AVX512}) {
+            if (!SpecialFunctions::supports(isa))
+                continue;
+            std::vector<double> res(x.size());
+            SpecialFunctions::digamma(x.data(), res.data(), x.size(), isa);
+            for (int i = 0; i < x.size(); ++i) {
+                REQUIRE( std::isnan(res[i]) == (x[i] <= 0) );
+            }
+        }
+    });
+}
+
+TEST_CASE( "Ops::digamma and Ops::log_gamma match torch on tensors" ) {
+    UnitTests::run([](){
+        Tensor x = torch::rand({3, 4, 7}).to(kDouble) * 50 + 0.01;
+        UnitTests::require_approximately_equal(Ops::digamma(x), torch::digamma(x));
+        UnitTests::require_approximately_equal(Ops::log_gamma(x), torch::lgamma(x));
+
+        // Non-contiguous and float tensors
+        Tensor t = x.transpose(0, 2);
+        UnitTests::require_approximately_equal(Ops::digamma(t), torch::digamma(t));
+        Tensor f = x.to(kFloat);
+        UnitTests::require_approximately_equal(Ops::log_gamma(f), torch::lgamma(f));
+    });
+}
+
+TEST_CASE( "Ops::log_beta does not overflow for large counts" ) {
+    UnitTests::run([](){
+        double res = Ops::log_beta(API::tensor({1000,2000}));
+        REQUIRE( std::isfinite(res) );
+        REQUIRE( res == Approx(-1911.8746142144482) );
+    });
+}
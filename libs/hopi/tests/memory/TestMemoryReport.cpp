@@ -0,0 +1,97 @@
+#include "catch.hpp"
+#include "memory/MemoryReport.h"
+#include "nodes/VarNode.h"
+#include "graphs/FactorGraph.h"
+#include "distributions/Categorical.h"
+#include "nodes/FactorNode.h"
+#include "api/API.h"
+#include "math/Ops.h"
+#include "helpers/UnitTests.h"
+#include <torch/torch.h>
+
+using namespace hopi::memory;
+using namespace hopi::nodes;
+using namespace hopi::graphs;
+using namespace hopi::distributions;
+using namespace hopi::api;
+using namespace hopi::math;
+using namespace torch;
+using namespace tests;
+
+TEST_CASE( "MemoryReport counts the tensors sharing the same storage only once" ) {
+    UnitTests::run([](){
+        MemoryReport report;
+        Tensor t = torch::zeros({10}).to(kDouble);
+        report.addTensor(PARAMETER_TENSORS, t);
+        report.addTensor(POSTERIOR_TENSORS, t.view({2, 5}));
+        report.addBytes(NODE_OBJECTS, 16);
+
+        REQUIRE( report.bytes(PARAMETER_TENSORS) == 10 * sizeof(double) );
+        REQUIRE( report.bytes(POSTERIOR_TENSORS) == 0 );
+        REQUIRE( report.total() == 10 * sizeof(double) + 16 );
+        REQUIRE( report.peak() == report.total() );
+    });
+}
+
+TEST_CASE( "FactorGraph.memory reports the bytes used by the nodes and their distributions" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        auto fg = FactorGraph::current();
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        VarNode *s0 = API::Categorical(torch::tensor({0.6, 0.3, 0.1}));
+        VarNode *o0 = API::Transition(s0, A);
+        o0->setType(VarNodeType::OBSERVED);
+        o0->setPosterior(Categorical::create(Ops::one_hot(2, 0)));
+
+        auto report = fg->memory();
+        REQUIRE( report.bytes(NODE_OBJECTS) >= 2 * sizeof(VarNode) );
+        REQUIRE( report.bytes(PARAMETER_TENSORS) >= (6 + 3) * sizeof(double) );
+        REQUIRE( report.bytes(POSTERIOR_TENSORS) > 0 );
+        REQUIRE( report.bytes(PLANNING_DATA) == 0 );
+        REQUIRE( report.total() == report.bytes(NODE_OBJECTS) + report.bytes(POSTERIOR_TENSORS) +
+            report.bytes(PARAMETER_TENSORS) + report.bytes(PLANNING_DATA) + report.bytes(MESSAGE_CACHES) );
+    });
+}
+
+TEST_CASE( "FactorGraph keeps track of the peak memory usage across calls to integrate" ) {
+    UnitTests::run([](){
+        Tensor A = torch::tensor({{0.8, 0.1, 0.3}, {0.2, 0.9, 0.7}});
+        Tensor B = torch::softmax(torch::arange(0, 18).to(kDouble).reshape({3,3,2}) / 5, 0);
+        FactorGraph::setCurrent(nullptr);
+        auto fg = FactorGraph::current();
+        fg->setWindowSize(1);
+        VarNode *s0 = API::Categorical(torch::tensor({0.6, 0.3, 0.1}));
+        fg->setTreeRoot(s0);
+        fg->setMemoryTracking(true);
+        fg->integrate(0, Ops::one_hot(2, 0), A, B);
+
+        // Expand the tree as the planner would, the expansion is cut-off by the next call to integrate
+        for (int i = 0; i < 10; ++i) {
+            VarNode *a = API::Categorical(Ops::one_hot(2, i % 2));
+            API::ActiveTransition(fg->treeRoot(), a, B);
+        }
+        auto expanded = fg->memory().total();
+        fg->integrate(1, Ops::one_hot(2, 1), A, B);
+
+        auto report = fg->memory();
+        REQUIRE( report.total() < expanded );
+        REQUIRE( report.peak() >= expanded );
+    });
+}
+
+TEST_CASE( "FactorNode does not cache the messages towards the Dirichlet nodes" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        auto fg = FactorGraph::current();
+        VarNode *s0 = API::Categorical(torch::tensor({0.6, 0.3, 0.1}));
+        VarNode *a0 = API::Categorical(torch::tensor({0.5, 0.5}));
+        VarNode *B = API::Dirichlet(torch::ones({3, 3, 2}));
+        VarNode *s1 = API::ActiveTransition(s0, a0, B);
+
+        auto before = fg->memory().bytes(MESSAGE_CACHES);
+        s1->parent()->message(B);
+        REQUIRE( fg->memory().bytes(MESSAGE_CACHES) == before );
+        s1->parent()->message(s0);
+        REQUIRE( fg->memory().bytes(MESSAGE_CACHES) > before );
+    });
+}
@@ -0,0 +1,66 @@
+#include "catch.hpp"
+#include "memory/PoolAllocator.h"
+#include "nodes/VarNode.h"
+#include "helpers/UnitTests.h"
+#include <thread>
+
+using namespace hopi::memory;
+using namespace hopi::nodes;
+using namespace tests;
+
+TEST_CASE( "PoolAllocator reuses the blocks that have been released" ) {
+    UnitTests::run([](){
+        PoolAllocator pool;
+        void *p1 = pool.allocate(40);
+        void *p2 = pool.allocate(48);
+        REQUIRE( p1 != p2 );
+        REQUIRE( pool.liveBlocks() == 2 );
+        REQUIRE( reinterpret_cast<std::uintptr_t>(p1) % PoolAllocator::ALIGNMENT == 0 );
+
+        pool.deallocate(p1, 40);
+        REQUIRE( pool.liveBlocks() == 1 );
+        REQUIRE( pool.allocate(33) == p1 );
+        REQUIRE( pool.reservedBytes() <= PoolAllocator::CHUNK_SIZE );
+    });
+}
+
+TEST_CASE( "PoolAllocator forwards large blocks to the global operator new" ) {
+    UnitTests::run([](){
+        PoolAllocator pool;
+        void *p = pool.allocate(PoolAllocator::MAX_BLOCK_SIZE + 1);
+        REQUIRE( p != nullptr );
+        REQUIRE( pool.liveBlocks() == 0 );
+        REQUIRE( pool.reservedBytes() == 0 );
+        pool.deallocate(p, PoolAllocator::MAX_BLOCK_SIZE + 1);
+    });
+}
+
+TEST_CASE( "PoolAllocator can be used concurrently by several threads" ) {
+    UnitTests::run([](){
+        PoolAllocator pool;
+        auto work = [&pool]() {
+            std::vector<void*> blocks;
+            for (int i = 0; i < 10000; ++i) {
+                blocks.push_back(pool.allocate(8 + i % 200));
+            }
+            for (int i = 0; i < 10000; ++i) {
+                pool.deallocate(blocks[i], 8 + i % 200);
+            }
+        };
+        std::thread t1(work);
+        std::thread t2(work);
+        t1.join();
+        t2.join();
+        REQUIRE( pool.liveBlocks() == 0 );
+    });
+}
+
+TEST_CASE( "Variable nodes are allocated from the pool" ) {
+    UnitTests::run([](){
+        auto before = PoolAllocator::instance().liveBlocks();
+        auto node = VarNode::create(VarNodeType::HIDDEN);
+        REQUIRE( PoolAllocator::instance().liveBlocks() > before );
+        node.reset();
+        REQUIRE( PoolAllocator::instance().liveBlocks() == before );
+    });
+}
@@ -36,6 +36,19 @@ TEST_CASE( "CategoricalNode.vfe() returns the proper vfe contribution" ) {
     });
 }
 
+TEST_CASE( "CategoricalNode.vfe() is re-computed when the posterior of an adjacent variable is updated" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        auto c1 = API::Categorical(Ops::uniform({4}));
+        double before = c1->parent()->vfe();
+
+        REQUIRE( c1->parent()->vfe() == before );
+        c1->posterior()->updateParams(torch::tensor({1.0, 2.0, 3.0, 4.0}));
+        REQUIRE( c1->parent()->vfe() == c1->parent()->computeVfe() );
+        REQUIRE( c1->parent()->vfe() != before );
+    });
+}
+
 TEST_CASE( "CategoricalNode.name getter and setter works properly" ) {
     UnitTests::run([](){
         auto to     = VarNode::create(VarNodeType::HIDDEN);
@@ -52,6 +52,45 @@ TEST_CASE( "TransitionNode returns the correct child and parents" ) {
     });
 }
 
+TEST_CASE( "TransitionNode.neighbours() returns all the (non-null) variables connected to the factor" ) {
+    UnitTests::run([](){
+        auto from   = VarNode::create(VarNodeType::HIDDEN);
+        auto to     = VarNode::create(VarNodeType::HIDDEN);
+        auto A      = VarNode::create(VarNodeType::HIDDEN);
+        auto factor = TransitionNode::create(from.get(), to.get());
+        auto neighbours = factor->neighbours();
+
+        REQUIRE( neighbours.size() == 2 );
+        REQUIRE( neighbours[0] == from.get() );
+        REQUIRE( neighbours[1] == to.get() );
+
+        factor = TransitionNode::create(from.get(), to.get(), A.get());
+        neighbours = factor->neighbours();
+        REQUIRE( neighbours.size() == 3 );
+        REQUIRE( neighbours[0] == from.get() );
+        REQUIRE( neighbours[1] == A.get() );
+        REQUIRE( neighbours[2] == to.get() );
+    });
+}
+
+TEST_CASE( "TransitionNode's messages are only re-computed when the posteriors of the other variables change" ) {
+    UnitTests::run([](){
+        FactorGraph::setCurrent(nullptr);
+        auto s0 = API::Categorical(Ops::uniform({4}));
+        auto s1 = API::Transition(s0, Ops::uniform({2,4}));
+        auto factor = s1->parent();
+
+        Tensor m1 = factor->message(s0);
+        s0->posterior()->updateParams(torch::tensor({1.0, 2.0, 3.0, 4.0}));
+        REQUIRE( factor->message(s0).is_same(m1) );
+
+        s1->posterior()->updateParams(torch::tensor({1.0, 2.0}));
+        Tensor m2 = factor->message(s0);
+        REQUIRE( !m2.is_same(m1) );
+        REQUIRE( torch::equal(m2, factor->computeMessage(s0)) );
+    });
+}
+
 TEST_CASE( "TransitionNode's (child and parent) messages are correct (no Dirichlet prior)" ) {
     UnitTests::run([](){
         FactorGraph::setCurrent(nullptr);
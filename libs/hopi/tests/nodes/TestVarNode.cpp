@@ -7,6 +7,7 @@
 #include "nodes/CategoricalNode.h"
 #include "distributions/Categorical.h"
 #include "distributions/Distribution.h"
+#include "algorithms/planning/MCTSNodeData.h"
 #include "helpers/UnitTests.h"
 #include "math/Ops.h"
 #include <iostream>
@@ -97,6 +98,21 @@ TEST_CASE( "VarNode's name getter/setter work properly" ) {
     });
 }
 
+TEST_CASE( "VarNode only allocates its planning data when they are accessed" ) {
+    UnitTests::run([](){
+        auto n1 = VarNode::create(VarNodeType::HIDDEN);
+
+        REQUIRE( !n1->hasData() );
+        REQUIRE( n1->action() == -1 );
+        REQUIRE( n1->dataOrDefault().visits == 0 );
+        REQUIRE( !n1->hasData() );
+        n1->data()->action = 2;
+        REQUIRE( n1->hasData() );
+        REQUIRE( n1->action() == 2 );
+        REQUIRE( n1->dataOrDefault().action == 2 );
+    });
+}
+
 TEST_CASE( "VarNode properly allows child addition and retrieval" ) {
     UnitTests::run([](){
         auto n1 = VarNode::create(VarNodeType::HIDDEN);